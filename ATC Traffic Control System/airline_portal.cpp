@@ -2,6 +2,7 @@
 //INSHARAH IRFAN 23I-0615
 //CS-D
 #include <iostream>
+#include <charconv>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -9,6 +10,18 @@
 #include <unistd.h>
 #include <sys/stat.h>
 #include <fstream>
+#include <string_view>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <ctime>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "avn_bus.h"
+#include "fifo_reader.h"
+#include "avn_journal.h"
 
 using namespace std;
 
@@ -51,173 +64,465 @@ bool parse_avn(std::ifstream& file, AVN& avn) {
 
 
 
-int main() {
-    vector<AVN> simAVNs;
-    vector<AVN> avn_history;
-    
-	// Get all puranay AVNs from the log File
+// Parse an AVN bus record ("AVN_ID=..,Flight=..,...") straight out of shared memory
+bool parse_avn_message(std::string_view msg, AVN& avn) {
+    size_t pos = 0;
+    while (pos < msg.length()) {
+        size_t next_pos = msg.find(',', pos);
+        if (next_pos == std::string_view::npos) next_pos = msg.length();
+        std::string_view token = msg.substr(pos, next_pos - pos);
+        pos = next_pos + 1;
+
+        if (token.rfind("AVN_ID=", 0) == 0) avn.avn_id = token.substr(7);
+        else if (token.rfind("Flight=", 0) == 0) avn.flight_id = token.substr(7);
+        else if (token.rfind("Airline=", 0) == 0) avn.airline = token.substr(8);
+        else if (token.rfind("Type=", 0) == 0) avn.aircraft_type = token.substr(5);
+        else if (token.rfind("Speed=", 0) == 0) avn.speed = token.substr(6);
+        else if (token.rfind("Issued=", 0) == 0) avn.issuance_time = token.substr(7);
+        else if (token.rfind("Fine=", 0) == 0) {
+            // the record may be torn (overwritten while we read it), so a bad number is not an exception
+            std::string_view fine = token.substr(5);
+            auto result = std::from_chars(fine.data(), fine.data() + fine.size(), avn.fine_amount);
+            if (result.ec != std::errc()) return false;
+        }
+        else if (token.rfind("Status=", 0) == 0) avn.payment_status = token.substr(7);
+        else if (token.rfind("Due=", 0) == 0) avn.due_date = token.substr(4);
+    }
+    // the generator terminates each message with a newline
+    if (!avn.due_date.empty() && avn.due_date.back() == '\n') avn.due_date.pop_back();
+    return !avn.avn_id.empty();
+}
+
+// In memory query engine over every AVN the portal has seen.
+// Records are append only; the indexes hold positions into `records` and are
+// updated as each AVN arrives, so no query ever scans the full history.
+class AvnIndex {
+public:
+    struct AirlineTotals {
+        size_t count = 0;
+        size_t unpaid_count = 0;
+        double unpaid_total = 0.0;
+        double paid_total = 0.0;
+    };
+
+    vector<AVN> records;
+
+    void add(const AVN& avn) {
+        size_t pos = records.size();
+        records.push_back(avn);
+        by_flight[avn.flight_id].push_back(pos);
+        by_airline[avn.airline].push_back(pos);
+        by_avn_id[avn.avn_id].push_back(pos);
+
+        // timestamps are "YYYY-MM-DD HH:MM:SS" so string order is time order;
+        // AVNs almost always arrive in order, making this an append
+        pair<string, size_t> entry(avn.issuance_time, pos);
+        if (by_time.empty() || by_time.back().first <= entry.first) by_time.push_back(entry);
+        else by_time.insert(upper_bound(by_time.begin(), by_time.end(), entry, time_less), entry);
+
+        AirlineTotals& totals = airline_totals[avn.airline];
+        totals.count++;
+        if (avn.payment_status == "paid") totals.paid_total += avn.fine_amount;
+        else {
+            totals.unpaid_count++;
+            totals.unpaid_total += avn.fine_amount;
+        }
+    }
+
+    // AVN IDs carry on across generator runs through the journal, so an ID
+    // normally names one AVN. Only an AVNlog.txt written before the journal
+    // existed can repeat IDs (they restarted with every run); there the newest
+    // unpaid AVN is the one StripePay was offered, since it replaced the older
+    // ones in its ledger.
+    AVN* mark_paid(const string& avn_id) {
+        auto it = by_avn_id.find(avn_id);
+        if (it == by_avn_id.end()) return nullptr;
+        for (auto pos = it->second.rbegin(); pos != it->second.rend(); ++pos) {
+            AVN& avn = records[*pos];
+            if (avn.payment_status == "paid") continue;
+            avn.payment_status = "paid";
+            AirlineTotals& totals = airline_totals[avn.airline];
+            totals.unpaid_count--;
+            totals.unpaid_total -= avn.fine_amount;
+            totals.paid_total += avn.fine_amount;
+            return &avn;
+        }
+        return nullptr;
+    }
+
+    bool contains(const string& avn_id) const { return by_avn_id.count(avn_id) != 0; }
+
+    const vector<size_t>& flight(const string& flight_id) const { return lookup(by_flight, flight_id); }
+    const vector<size_t>& airline(const string& airline_name) const { return lookup(by_airline, airline_name); }
+
+    // AVNs issued in [from, to]; dates may be "YYYY-MM-DD" or full timestamps
+    vector<size_t> issued_between(const string& from, string to) const {
+        if (to.size() == 10) to += " 23:59:59";
+        auto lo = lower_bound(by_time.begin(), by_time.end(), make_pair(from, size_t(0)), time_less);
+        auto hi = upper_bound(by_time.begin(), by_time.end(), make_pair(to, size_t(0)), time_less);
+        vector<size_t> out;
+        for (auto it = lo; it < hi; ++it) out.push_back(it->second);
+        return out;
+    }
+
+    const unordered_map<string, AirlineTotals>& totals() const { return airline_totals; }
+
+private:
+    static bool time_less(const pair<string, size_t>& a, const pair<string, size_t>& b) {
+        return a.first < b.first;
+    }
+
+    static const vector<size_t>& lookup(const unordered_map<string, vector<size_t>>& index, const string& key) {
+        static const vector<size_t> none;
+        auto it = index.find(key);
+        return it == index.end() ? none : it->second;
+    }
+
+    unordered_map<string, vector<size_t>> by_flight;
+    unordered_map<string, vector<size_t>> by_airline;
+    unordered_map<string, vector<size_t>> by_avn_id;
+    vector<pair<string, size_t>> by_time;  // sorted by issuance time
+    unordered_map<string, AirlineTotals> airline_totals;
+};
+
+// Counters kept by the ingest thread; read from the prompt without locking
+struct IngestStats {
+    atomic<uint64_t> ingested{0};
+    atomic<uint64_t> payments{0};
+    atomic<uint64_t> lag_samples{0};
+    atomic<uint64_t> lag_total_ns{0};
+    atomic<uint64_t> lag_max_ns{0};
+    atomic<uint64_t> lag_last_ns{0};
+    atomic<uint64_t> bus_backlog{0};   // bytes on the bus not read yet
+    atomic<uint64_t> bus_lost{0};      // bytes overwritten before we read them
+    atomic<uint64_t> fifo_buffered{0}; // bytes of a partial confirmation waiting for the rest
+
+    // lag = time from the generator publishing an AVN to it being indexed here
+    void record_lag(uint64_t ns) {
+        lag_samples++;
+        lag_total_ns += ns;
+        lag_last_ns = ns;
+        if (ns > lag_max_ns) lag_max_ns = ns;
+    }
+
+    void print() const {
+        uint64_t samples = lag_samples;
+        std::cout << "[Airline Portal] Ingest stats:" << std::endl
+                  << "  AVNs indexed: " << ingested << ", payments applied: " << payments << std::endl
+                  << "  Lag (ms) last: " << lag_last_ns / 1e6
+                  << ", avg: " << (samples ? lag_total_ns / samples / 1e6 : 0.0)
+                  << ", max: " << lag_max_ns / 1e6 << std::endl
+                  << "  Bus backlog: " << bus_backlog << " bytes, lost: " << bus_lost << " bytes" << std::endl
+                  << "  FIFO partial record buffered: " << fifo_buffered << " bytes" << std::endl;
+    }
+};
+
+const int INGEST_INTERVAL_MS = 50;
+const size_t MAX_ROWS_SHOWN = 50; // longer results print a count and the first rows only
+
+// totals get large, print them in full rather than in scientific notation
+std::string format_amount(double amount) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2) << amount;
+    return ss.str();
+}
+
+void print_avn_details(const AVN& avn) {
+    std::cout << "  AVN ID: " << avn.avn_id << std::endl
+              << "  Flight: " << avn.flight_id << std::endl
+              << "  Airline: " << avn.airline << std::endl
+              << "  Aircraft Type: " << avn.aircraft_type << std::endl
+              << "  Speed (Recorded/Permissible): " << avn.speed << std::endl
+              << "  Issuance Time: " << avn.issuance_time << std::endl
+              << "  Fine Amount: PKR " << avn.fine_amount << std::endl
+              << "  Payment Status: " << avn.payment_status << std::endl
+              << "  Due Date: " << avn.due_date << std::endl;
+}
+
+void print_avn_rows(const AvnIndex& index, const vector<size_t>& rows) {
+    for (size_t i = 0; i < rows.size() && i < MAX_ROWS_SHOWN; i++) {
+        const AVN& avn = index.records[rows[i]];
+        std::cout << "  - AVN ID: " << avn.avn_id
+                  << ", Flight: " << avn.flight_id
+                  << ", Issued: " << avn.issuance_time
+                  << ", Fine: PKR " << avn.fine_amount
+                  << ", Status: " << avn.payment_status
+                  << ", Due: " << avn.due_date << std::endl;
+    }
+    if (rows.size() > MAX_ROWS_SHOWN) {
+        std::cout << "  ... " << rows.size() - MAX_ROWS_SHOWN << " more" << std::endl;
+    }
+}
+
+// --bench N: fill an index with N synthetic AVNs and time the queries
+void run_bench(size_t count) {
+    AvnIndex index;
+    auto start = chrono::steady_clock::now();
+    char stamp[32];
+    for (size_t i = 0; i < count; i++) {
+        AVN avn;
+        avn.avn_id = "AVN" + to_string(i);
+        avn.flight_id = "PK" + to_string(i % 5000);
+        avn.airline = "AIR" + to_string(i % 50);
+        avn.aircraft_type = "Commercial";
+        avn.speed = "650/400 - 600";
+        std::time_t t = 1735689600 + i * 7; // from 2025-01-01, one AVN every 7 seconds
+        std::tm tm_utc;
+        gmtime_r(&t, &tm_utc);
+        strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm_utc);
+        avn.issuance_time = stamp;
+        avn.fine_amount = 575000.0;
+        avn.payment_status = (i % 3 == 0) ? "paid" : "unpaid";
+        avn.due_date = avn.issuance_time.substr(0, 10);
+        index.add(avn);
+    }
+    double load_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    std::cout << "[Airline Portal] Indexed " << count << " AVNs in " << load_ms << " ms" << std::endl;
+
+    auto time_query = [](const char* name, auto&& query) {
+        const int runs = 1000;
+        size_t results = 0;
+        auto t0 = chrono::steady_clock::now();
+        for (int r = 0; r < runs; r++) results = query(r);
+        double us = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count() / runs;
+        std::cout << "  " << name << ": " << us << " us/query (" << results << " results)" << std::endl;
+    };
+    time_query("flight", [&](int r) { return index.flight("PK" + to_string(r % 5000)).size(); });
+    time_query("airline", [&](int r) { return index.airline("AIR" + to_string(r % 50)).size(); });
+    time_query("one day range", [&](int) { return index.issued_between("2025-01-05", "2025-01-05").size(); });
+    time_query("unpaid per airline", [&](int) {
+        double total = 0;
+        for (const auto& entry : index.totals()) total += entry.second.unpaid_total;
+        return static_cast<size_t>(total > 0);
+    });
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        run_bench(argc > 2 ? std::stoul(argv[2]) : 1000000);
+        return 0;
+    }
+
+    AvnIndex index;
+
+    // Attach to the AVN bus first: the generator journals an AVN before publishing
+    // it, so anything before this head is in the journal and anything after is on the bus
+    AvnBus bus;
+    if (!bus.attach()) {
+        std::cerr << "[Airline Portal] Failed to attach to AVN bus (is atc_controller running?)" << std::endl;
+        return 1;
+    }
+    uint64_t start = bus.head();
+
+    // Get all puranay AVNs, with payment status, from the generator's journal
+    AvnJournal journal;
+    bool from_journal = journal.load() && !journal.avns().empty();
+    if (from_journal) {
+        for (const JournalAvn& entry : journal.avns()) {
+            AVN avn;
+            if (!parse_avn_message(entry.message, avn)) continue;
+            avn.payment_status = entry.paid ? "paid" : "unpaid";
+            index.add(avn);
+        }
+        std::cout << "[Airline Portal] Loaded " << index.records.size() << " AVNs from the AVN journal in "
+                  << journal.stats().recovery_ms << " ms" << std::endl;
+    } else {
+	// No journal yet: fall back to the log File (it has no payment updates)
 	std::ifstream logFileIn("AVNlog.txt");
 	if (logFileIn.is_open()) {
 		AVN avn;
 		while (parse_avn(logFileIn, avn)) {
-		    avn_history.push_back(avn);
+		    index.add(avn);
 		}
 		logFileIn.close();
-		std::cout << "[AVN Generator] Loaded " << avn_history.size() << " AVNs from AVNlog.txt" << std::endl;
+		std::cout << "[Airline Portal] Loaded " << index.records.size() << " AVNs from AVNlog.txt" << std::endl;
 	} else {
-		std::cout << "[AVN Generator] No existing AVNlog.txt, starting fresh" << std::endl;
+		std::cout << "[Airline Portal] No existing AVNlog.txt, starting fresh" << std::endl;
 	}
+    }
 
-    // Open portal FIFO for reading
+    // History before now already came from the journal/AVNlog.txt,
+    // so only read new records unless asked to replay (--replay [offset])
+    bool replay = argc > 1 && std::string(argv[1]) == "--replay";
+    if (replay) start = (argc > 2) ? std::stoull(argv[2]) : bus.tail();
+    AvnBusReader reader(bus, start);
+    if (replay) {
+        std::cout << "[Airline Portal] Replaying AVN bus from offset " << reader.position() << std::endl;
+    }
+
+    // Open portal FIFO for reading payment confirmations from StripePay
     const char* portal_fifo = "portal_fifo";
-int portal_fd = open(portal_fifo, O_RDONLY | O_NONBLOCK);
+    int portal_fd = open(portal_fifo, O_RDONLY | O_NONBLOCK);
     if (portal_fd == -1) {
         std::cerr << "[Airline Portal] Failed to open portal FIFO" << std::endl;
         return 1;
     }
+    FramedReader portal_reader; // confirmations are newline terminated and may arrive split or batched
+    std::vector<std::string_view> portal_msgs;
 
-std::string flight_id, issuance_date;
-while (true) {
-    // Prompt for FlightID and issuance date
-    std::cout << "\n[Airline Portal] Enter FlightID (or press Enter to exit): ";
-    std::getline(std::cin, flight_id);
-    if (flight_id.empty()) break; // Exit if FlightID is empty
-    std::cout << "[Airline Portal] Enter AVN Issuance Date (YYYY-MM-DD): ";
-    std::getline(std::cin, issuance_date);
+    // Background ingest: drain the bus and the FIFO every INGEST_INTERVAL_MS whether
+    // or not anyone is typing a query, so neither backs up between queries
+    mutex index_mutex;
+    IngestStats stats;
+    atomic<bool> running{true};
+    thread ingest_thread([&]() {
+        vector<AVN> batch;
+        vector<string> paid_ids;
+        while (running) {
+            batch.clear();
+            paid_ids.clear();
+            uint64_t now_ns = avn_bus_now_ns();
 
-    bool found = false;
+            // Parse new AVNs straight out of the bus, outside the index lock
+            AvnRecord rec;
+            while (reader.next(rec)) {
+                std::string_view msg(rec.data, rec.length);
+                if (msg.find("AVN_ID=") == std::string_view::npos) continue; // only AVNs here, StripePay confirmations arrive on the FIFO
 
-    // Read available messages from FIFO
-    char buffer[512];
-    while (true) {
-        ssize_t n = read(portal_fd, buffer, sizeof(buffer) - 1);
-        if (n <= 0) break; // No more messages or error
-        buffer[n] = '\0';
-        std::string msg = buffer;
-
-        // Check if it's an AVN or payment update
-        if (msg.find("AVN_ID=") != std::string::npos) {
-            // Parse AVN message
-            AVN avn;
-            size_t pos = 0;
-            std::string token;
-            while (pos < msg.length()) {
-                size_t next_pos = msg.find(',', pos);
-                if (next_pos == std::string::npos) next_pos = msg.length();
-                token = msg.substr(pos, next_pos - pos);
-                pos = next_pos + 1;
-
-                if (token.find("AVN_ID=") == 0) avn.avn_id = token.substr(7);
-                else if (token.find("Flight=") == 0) avn.flight_id = token.substr(7);
-                else if (token.find("Airline=") == 0) avn.airline = token.substr(8);
-                else if (token.find("Type=") == 0) avn.aircraft_type = token.substr(5);
-                else if (token.find("Speed=") == 0) avn.speed = token.substr(6);
-                else if (token.find("Issued=") == 0) avn.issuance_time = token.substr(7);
-                else if (token.find("Fine=") == 0) avn.fine_amount = std::stod(token.substr(5));
-                else if (token.find("Status=") == 0) avn.payment_status = token.substr(7);
-                else if (token.find("Due=") == 0) avn.due_date = token.substr(4);
+                AVN avn;
+                bool parsed = parse_avn_message(msg, avn);
+                if (!reader.intact(rec)) continue; // overwritten while we parsed it
+                if (!parsed) {
+                    std::cerr << "[Airline Portal] Invalid message: " << msg << std::endl;
+                    continue;
+                }
+                stats.record_lag(now_ns > rec.publish_ns ? now_ns - rec.publish_ns : 0);
+                batch.push_back(avn);
             }
 
-            // Store in history
-            avn_history.push_back(avn);
-
-            // Check if matches user input
-            if (avn.flight_id == flight_id && avn.issuance_time.substr(0, 10) == issuance_date) { // to check against date only not time
-                found = true;
-                std::cout << "[Airline Portal] Matching AVN Found:" << std::endl;
-                std::cout << "  AVN ID: " << avn.avn_id << std::endl
-                          << "  Flight: " << avn.flight_id << std::endl
-                          << "  Airline: " << avn.airline << std::endl
-                          << "  Aircraft Type: " << avn.aircraft_type << std::endl
-                          << "  Speed (Recorded/Permissible): " << avn.speed << std::endl
-                          << "  Issuance Time: " << avn.issuance_time << std::endl
-                          << "  Fine Amount: PKR " << avn.fine_amount << std::endl
-                          << "  Payment Status: " << avn.payment_status << std::endl
-                          << "  Due Date: " << avn.due_date << std::endl;
+            // Payment confirmations from FIFO, one record at a time
+            portal_reader.read_from(portal_fd, portal_msgs);
+            for (std::string_view record : portal_msgs) {
+                std::string msg(record);
+                if (msg.find("AVN=") != std::string::npos && msg.find("Status=paid") != std::string::npos) {
+                    size_t avn_pos = msg.find("AVN=");
+                    size_t comma_pos = msg.find(',', avn_pos);
+                    if (comma_pos != std::string::npos) {
+                        paid_ids.push_back(msg.substr(avn_pos + 4, comma_pos - (avn_pos + 4)));
+                    }
+                } else {
+                    std::cerr << "[Airline Portal] Invalid message: " << msg << std::endl;
+                }
             }
-        } else if (msg.find("AVN=") != std::string::npos && msg.find("Status=paid") != std::string::npos) {
-    // Parse payment update
-    std::string paid_avn_id;
-    size_t avn_pos = msg.find("AVN=");
-    if (avn_pos != std::string::npos) {
-        size_t comma_pos = msg.find(',', avn_pos);
-        if (comma_pos != std::string::npos) {
-            paid_avn_id = msg.substr(avn_pos + 4, comma_pos - (avn_pos + 4));
-        }
-    }
-    // Update payment status in history
-    bool found = false;
-    for (auto& avn : avn_history) {
-        if (avn.avn_id == paid_avn_id) {
-            avn.payment_status = "paid";
-            found = true;
-            std::cout << "[Airline Portal] Payment confirmed for AVN=" << paid_avn_id << std::endl;
-            std::cout << "  AVN ID: " << avn.avn_id << std::endl
-                      << "  Flight: " << avn.flight_id << std::endl
-                      << "  Airline: " << avn.airline << std::endl
-                      << "  Type: " << avn.aircraft_type << std::endl
-                      << "  Speed: " << avn.speed << std::endl
-                      << "  Issued: " << avn.issuance_time << std::endl
-                      << "  Fine: PKR " << avn.fine_amount << std::endl
-                      << "  Status: " << avn.payment_status << std::endl
-                      << "  Due: " << avn.due_date << std::endl;
-            break; // Update only the matching AVN
-        }
-    }
-    if (!found) {
-        std::cout << "[Airline Portal] No AVN found for AVN=" << paid_avn_id << std::endl;
-    }
-    // Check if the matching AVN is now paid
-    if (found) {
-        for (const auto& avn : avn_history) {
-            if (avn.avn_id == paid_avn_id && avn.flight_id == flight_id && avn.issuance_time.substr(0, 10) == issuance_date) {
-                std::cout << "[Airline Portal] Updated Matching AVN (now paid):" << std::endl;
-                std::cout << "  AVN ID: " << avn.avn_id << std::endl
-                          << "  Flight: " << avn.flight_id << std::endl
-                          << "  Airline: " << avn.airline << std::endl
-                          << "  Type: " << avn.aircraft_type << std::endl
-                          << "  Speed: " << avn.speed << std::endl
-                          << "  Issued: " << avn.issuance_time << std::endl
-                          << "  Fine: PKR " << avn.fine_amount << std::endl
-                          << "  Status: " << avn.payment_status << std::endl
-                          << "  Due: " << avn.due_date << std::endl;
-                break;
+
+            if (!batch.empty() || !paid_ids.empty()) {
+                lock_guard<mutex> lock(index_mutex);
+                for (const AVN& avn : batch) {
+                    // journal IDs are unique, so one we already hold was loaded at startup or replayed twice
+                    if (from_journal && index.contains(avn.avn_id)) continue;
+                    index.add(avn);
+                }
+                for (const string& paid_avn_id : paid_ids) {
+                    if (index.mark_paid(paid_avn_id)) {
+                        std::cout << "\n[Airline Portal] Payment confirmed for AVN=" << paid_avn_id << std::endl;
+                    } else {
+                        std::cout << "\n[Airline Portal] No AVN found for AVN=" << paid_avn_id << std::endl;
+                    }
+                }
             }
+            stats.ingested += batch.size();
+            stats.payments += paid_ids.size();
+            stats.bus_backlog = reader.backlog();
+            stats.bus_lost = reader.lost();
+            stats.fifo_buffered = portal_reader.buffered();
+            this_thread::sleep_for(chrono::milliseconds(INGEST_INTERVAL_MS));
         }
-    }
-} else {
-            std::cerr << "[Airline Portal] Invalid message: " << msg << std::endl;
-        }
-    }
+    });
 
-    // Display history for FlightID
-    std::cout << "\n[Airline Portal] AVN History for FlightID=" << flight_id << ":" << std::endl;
-    bool has_history = false;
-    for (const auto& avn : avn_history) {
-        if (avn.flight_id == flight_id) {
-            has_history = true;
-            std::cout << "  - AVN ID: " << avn.avn_id
-                      << ", Issued: " << avn.issuance_time
-                      << ", Fine: PKR " << avn.fine_amount
-                      << ", Status: " << avn.payment_status
-                      << ", Due: " << avn.due_date << std::endl;
+    while (true) {
+        std::cout << "\n[Airline Portal] Queries:" << std::endl
+                  << "  1. AVN by FlightID and issuance date" << std::endl
+                  << "  2. AVN history for a FlightID" << std::endl
+                  << "  3. AVNs for an airline" << std::endl
+                  << "  4. AVNs issued in a date range" << std::endl
+                  << "  5. Unpaid fines per airline" << std::endl
+                  << "  6. Ingest lag and backlog" << std::endl
+                  << "[Airline Portal] Choose a query (or press Enter to exit): ";
+        std::string choice;
+        std::getline(std::cin, choice);
+        if (choice.empty()) break; // Exit on empty input
+
+        std::string flight_id, issuance_date, airline, from_date, to_date;
+        if (choice == "1" || choice == "2") {
+            std::cout << "[Airline Portal] Enter FlightID: ";
+            std::getline(std::cin, flight_id);
+        }
+        if (choice == "1") {
+            std::cout << "[Airline Portal] Enter AVN Issuance Date (YYYY-MM-DD): ";
+            std::getline(std::cin, issuance_date);
+        } else if (choice == "3") {
+            std::cout << "[Airline Portal] Enter Airline: ";
+            std::getline(std::cin, airline);
+        } else if (choice == "4") {
+            std::cout << "[Airline Portal] Enter start date (YYYY-MM-DD): ";
+            std::getline(std::cin, from_date);
+            std::cout << "[Airline Portal] Enter end date (YYYY-MM-DD): ";
+            std::getline(std::cin, to_date);
+        } else if (choice == "6") {
+            stats.print();
+            continue;
         }
-    }
-    if (!has_history) {
-        std::cout << "  No AVNs found for FlightID=" << flight_id << std::endl;
-    }
 
-    if (!found) {
-        std::cout << "[Airline Portal] No AVN found for FlightID=" << flight_id
-                  << " and Issuance Date=" << issuance_date << std::endl;
+        lock_guard<mutex> lock(index_mutex);
+        auto query_start = chrono::steady_clock::now();
+        if (choice == "1") {
+            bool found = false;
+            for (size_t pos : index.flight(flight_id)) {
+                const AVN& avn = index.records[pos];
+                if (avn.issuance_time.compare(0, 10, issuance_date) == 0) { // to check against date only not time
+                    found = true;
+                    std::cout << "[Airline Portal] Matching AVN Found:" << std::endl;
+                    print_avn_details(avn);
+                }
+            }
+            if (!found) {
+                std::cout << "[Airline Portal] No AVN found for FlightID=" << flight_id
+                          << " and Issuance Date=" << issuance_date << std::endl;
+            }
+        }
+        if (choice == "1" || choice == "2") {
+            // Display history for FlightID
+            const vector<size_t>& rows = index.flight(flight_id);
+            std::cout << "\n[Airline Portal] AVN History for FlightID=" << flight_id << ":" << std::endl;
+            if (rows.empty()) std::cout << "  No AVNs found for FlightID=" << flight_id << std::endl;
+            print_avn_rows(index, rows);
+        } else if (choice == "3") {
+            const vector<size_t>& rows = index.airline(airline);
+            auto totals = index.totals().find(airline);
+            std::cout << "\n[Airline Portal] " << rows.size() << " AVNs for Airline=" << airline;
+            if (totals != index.totals().end()) {
+                std::cout << " (unpaid: " << totals->second.unpaid_count
+                          << ", PKR " << format_amount(totals->second.unpaid_total) << ")";
+            }
+            std::cout << std::endl;
+            print_avn_rows(index, rows);
+        } else if (choice == "4") {
+            vector<size_t> rows = index.issued_between(from_date, to_date);
+            std::cout << "\n[Airline Portal] " << rows.size() << " AVNs issued from " << from_date
+                      << " to " << to_date << ":" << std::endl;
+            print_avn_rows(index, rows);
+        } else if (choice == "5") {
+            std::cout << "\n[Airline Portal] Unpaid fines per airline:" << std::endl;
+            vector<pair<string, AvnIndex::AirlineTotals>> rows(index.totals().begin(), index.totals().end());
+            sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+            for (const auto& row : rows) {
+                std::cout << "  " << std::left << std::setw(12) << row.first << std::right
+                          << " unpaid " << std::setw(6) << row.second.unpaid_count
+                          << " of " << std::setw(6) << row.second.count
+                          << "   PKR " << format_amount(row.second.unpaid_total) << std::endl;
+            }
+            if (rows.empty()) std::cout << "  No AVNs yet" << std::endl;
+        } else {
+            std::cout << "[Airline Portal] Unknown query " << choice << std::endl;
+            continue;
+        }
+        double query_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - query_start).count();
+        std::cout << "[Airline Portal] (" << index.records.size() << " AVNs indexed, query took " << query_ms << " ms)" << std::endl;
     }
-}
-
-// Cleanup
-close(portal_fd);
-return 0;
 
+    // Cleanup
+    running = false;
+    ingest_thread.join();
+    close(portal_fd);
+    return 0;
 }
-
-
-
@@ -16,22 +16,52 @@
 #include <algorithm>
 #include <ctime>
 #include <cstdlib>
+#include <cstring>
+#include <iterator>
 #include <array>
+#include <deque>
+#include <string_view>
+#include <charconv>
+#include <new>
+#include <memory>
+#include <cmath>
+#include <cstdarg>
+#include <cerrno>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
 #include <SFML/Graphics.hpp>
+#include "event_store.h"
+#include "tick_trace.h"
+#include "term_view.h"
+#include "fifo_reader.h"
+#include "avn_supervisor.h"
+#include "avn_emitter.h"
 
 
 using namespace std;
 
 // Constants
 const int MAX_ACTIVE_FLIGHTS = 20;
-const int MAX_RUNWAYS = 3;
+const int MAX_PLAN_FLIGHTS = 1000; // every flight gets a radar thread, --plan refuses bigger plans
+const int MAX_RUNWAYS = 12; // upper bound on runways in the topology file
+const char* RUNWAY_CONFIG_FILE = "runways.cfg";
+const char* EVENT_FILE = "events.evc"; // typed events for event_query, next to log.txt
+const char* SLOW_TICK_FILE = "slow_ticks.json"; // Chrome trace of ticks that went over budget
+const int TICK_BUDGET_US = 50000; // tick loop work above this (50 ms) is traced
 const int SIMULATION_DURATION = 300; // 5 minutes in seconds
+const int ADMIT_LEAD_SECONDS = 30; // flights join the simulation this long before their mapped second
 const double LOW_FUEL_THRESHOLD = 20.0; // 20%
 
 // for sfml window - resize to change window size
 const int resolutionX = 800;
 const int resolutionY = 600;
+const unsigned DEFAULT_FRAME_CAP = 60; // GUI frames per second at most, --fps overrides
+const unsigned DEFAULT_EXPORT_FPS = 10; // offscreen export frame rate, --render-fps overrides
+const int STATUS_PAGE_SECONDS = 3;      // console status shows each page of flights this long
+const int STATUS_PLAIN_SECONDS = 10;    // status line interval when stdout is not a terminal
 
 //for input
 struct FlightInputData 
@@ -60,10 +90,305 @@ AppState currentState = INPUT_STATE; //always start on input
 // Enums for acutal air traffic
 enum AircraftType { COMMERCIAL, CARGO, EMERGENCY };
 enum FlightPhase { HOLDING, APPROACH, LANDING, TAXI, AT_GATE, TAKEOFF_ROLL, CLIMB, CRUISE };
-enum RunwayID { RWY_A, RWY_B, RWY_C };
 enum Direction { NORTH, SOUTH, EAST, WEST };
+enum QueuePolicy { SCHEDULED, IMMEDIATE }; // scheduled = wait for mapped slot, immediate = dispatch as soon as queued
+
+// Runways are indexed by their position in the topology file
+typedef int RunwayID;
+const RunwayID NO_RUNWAY = -1;
 
 // Structs
+// One line of runways.cfg: which directions and aircraft types a runway serves and how its queue releases flights
+struct RunwayConfig {
+    string name;             // e.g. RWY-A
+    string role;             // e.g. Arrivals
+    unsigned directionMask;  // bit per Direction
+    unsigned typeMask;       // bit per AircraftType
+    QueuePolicy policy;
+
+    bool allows(AircraftType type, Direction dir) const {
+        return (typeMask & (1u << type)) && (directionMask & (1u << dir));
+    }
+
+    // serves both arrivals and departures, so flights on it use the combined phase sequence
+    bool mixedUse() const {
+        const unsigned arrivals = (1u << NORTH) | (1u << SOUTH);
+        const unsigned departures = (1u << EAST) | (1u << WEST);
+        return (directionMask & arrivals) && (directionMask & departures);
+    }
+};
+
+// Active runway topology, loaded once at startup by AirControlX
+vector<RunwayConfig> runwayConfigs;
+
+// The original fixed airport: RWY-A arrivals, RWY-B departures, RWY-C cargo/emergency
+vector<RunwayConfig> defaultRunwayConfig() {
+    const unsigned allDirections = (1u << NORTH) | (1u << SOUTH) | (1u << EAST) | (1u << WEST);
+    return {
+        {"RWY-A", "Arrivals", (1u << NORTH) | (1u << SOUTH), 1u << COMMERCIAL, SCHEDULED},
+        {"RWY-B", "Departures", (1u << EAST) | (1u << WEST), 1u << COMMERCIAL, SCHEDULED},
+        {"RWY-C", "Cargo/Emergency", allDirections, (1u << CARGO) | (1u << EMERGENCY), IMMEDIATE}
+    };
+}
+
+// Reads runways.cfg. Each non-comment line is: name role directions types policy
+//   e.g. RWY-A Arrivals N,S COMMERCIAL scheduled
+// directions are any of N,S,E,W (or ANY), types any of COMMERCIAL,CARGO,EMERGENCY (or ANY),
+// policy is scheduled or immediate. Returns false with a message if the file is unusable.
+bool loadRunwayConfig(const string& path, vector<RunwayConfig>& out, string& error) {
+    ifstream in(path);
+    if (!in.is_open()) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    vector<RunwayConfig> parsed;
+    string line;
+    int lineNo = 0;
+    while (getline(in, line)) {
+        lineNo++;
+        size_t hashPos = line.find('#');
+        if (hashPos != string::npos) line = line.substr(0, hashPos);
+
+        stringstream ss(line);
+        RunwayConfig cfg;
+        string dirs, types, policy;
+        if (!(ss >> cfg.name)) continue; // blank line
+        if (!(ss >> cfg.role >> dirs >> types >> policy)) {
+            error = path + ":" + to_string(lineNo) + ": expected name role directions types policy";
+            return false;
+        }
+
+        cfg.directionMask = 0;
+        stringstream dirSS(dirs);
+        string token;
+        while (getline(dirSS, token, ',')) {
+            if (token == "N") cfg.directionMask |= 1u << NORTH;
+            else if (token == "S") cfg.directionMask |= 1u << SOUTH;
+            else if (token == "E") cfg.directionMask |= 1u << EAST;
+            else if (token == "W") cfg.directionMask |= 1u << WEST;
+            else if (token == "ANY") cfg.directionMask |= (1u << NORTH) | (1u << SOUTH) | (1u << EAST) | (1u << WEST);
+            else {
+                error = path + ":" + to_string(lineNo) + ": unknown direction " + token;
+                return false;
+            }
+        }
+
+        cfg.typeMask = 0;
+        stringstream typeSS(types);
+        while (getline(typeSS, token, ',')) {
+            if (token == "COMMERCIAL") cfg.typeMask |= 1u << COMMERCIAL;
+            else if (token == "CARGO") cfg.typeMask |= 1u << CARGO;
+            else if (token == "EMERGENCY") cfg.typeMask |= 1u << EMERGENCY;
+            else if (token == "ANY") cfg.typeMask |= (1u << COMMERCIAL) | (1u << CARGO) | (1u << EMERGENCY);
+            else {
+                error = path + ":" + to_string(lineNo) + ": unknown aircraft type " + token;
+                return false;
+            }
+        }
+
+        if (policy == "scheduled") cfg.policy = SCHEDULED;
+        else if (policy == "immediate") cfg.policy = IMMEDIATE;
+        else {
+            error = path + ":" + to_string(lineNo) + ": unknown queue policy " + policy;
+            return false;
+        }
+
+        parsed.push_back(cfg);
+    }
+
+    if (parsed.empty() || parsed.size() > MAX_RUNWAYS) {
+        error = path + ": need between 1 and " + to_string(MAX_RUNWAYS) + " runways, found " + to_string(parsed.size());
+        return false;
+    }
+
+    // every aircraft type / direction pair must have somewhere to go or it would sit in no queue forever
+    for (int t = COMMERCIAL; t <= EMERGENCY; t++) {
+        for (int d = NORTH; d <= WEST; d++) {
+            bool covered = any_of(parsed.begin(), parsed.end(), [&](const RunwayConfig& cfg) {
+                return cfg.allows(static_cast<AircraftType>(t), static_cast<Direction>(d));
+            });
+            if (!covered) {
+                const char* typeNames[] = {"COMMERCIAL", "CARGO", "EMERGENCY"};
+                error = path + ": no runway accepts " + typeNames[t] + " aircraft from direction " + string(1, "NSEW"[d]);
+                return false;
+            }
+        }
+    }
+
+    out = parsed;
+    return true;
+}
+
+// ---------------- STRINGS & ALLOCATIONS ----------------
+
+// Heap allocation counter: every operator new bumps the calling thread's count,
+// so the tick loop can check it runs without touching the heap
+thread_local unsigned long threadAllocations = 0;
+
+void* operator new(size_t size)
+{
+    threadAllocations++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// Intern table for flight ids, airline names and schedule strings: each distinct
+// string is stored once and flights hold string_views into it. The text lives in
+// 64 KB blocks that are never freed or moved, so the views stay valid for the whole
+// run. Lookups go through an open addressing hash table (linear probing, hashes
+// cached in the slots), which keeps bulk loads of unique flight ids cheap.
+class StringTable
+{
+public:
+    StringTable() : slots(1024) {}
+
+    string_view intern(string_view s)
+    {
+        uint32_t hash = hashOf(s);
+        lock_guard<mutex> lock(mtx);
+        size_t mask = slots.size() - 1;
+        for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+            Slot& slot = slots[i];
+            if (!slot.data) break;
+            if (slot.hash == hash && slot.size == s.size() && memcmp(slot.data, s.data(), s.size()) == 0)
+                return string_view(slot.data, slot.size);
+        }
+        string_view kept = store(s);
+        if ((count + 1) * 2 > slots.size()) grow(slots.size() * 2);
+        place({kept.data(), static_cast<uint32_t>(kept.size()), hash});
+        count++;
+        return kept;
+    }
+
+    size_t size() const
+    {
+        lock_guard<mutex> lock(mtx);
+        return count;
+    }
+
+    // Make room for about n more strings, so a bulk load does not keep rehashing
+    void reserve(size_t n)
+    {
+        lock_guard<mutex> lock(mtx);
+        size_t wanted = slots.size();
+        while (wanted < (count + n) * 2) wanted *= 2;
+        if (wanted != slots.size()) grow(wanted);
+    }
+
+    // Take over another table's strings under one lock. Its blocks move here, so views
+    // into it stay valid; a string both tables hold keeps the copy already in this one
+    // as the canonical entry, the other copy just stays alive for the views into it.
+    void absorb(StringTable& other)
+    {
+        scoped_lock lock(mtx, other.mtx);
+        size_t wanted = slots.size();
+        while (wanted < (count + other.count) * 2) wanted *= 2;
+        if (wanted != slots.size()) grow(wanted);
+        size_t mask = slots.size() - 1;
+        for (const Slot& entry : other.slots) {
+            if (!entry.data) continue;
+            size_t i = entry.hash & mask;
+            for (; slots[i].data; i = (i + 1) & mask) {
+                if (slots[i].hash == entry.hash && slots[i].size == entry.size &&
+                    memcmp(slots[i].data, entry.data, entry.size) == 0) break;
+            }
+            if (slots[i].data) continue;
+            slots[i] = entry;
+            count++;
+        }
+        move(other.blocks.begin(), other.blocks.end(), back_inserter(blocks));
+        move(other.big.begin(), other.big.end(), back_inserter(big));
+        other.blocks.clear();
+        other.big.clear();
+        other.slots.assign(1024, Slot());
+        other.count = 0;
+        other.used = 0;
+    }
+
+private:
+    static const size_t BLOCK_SIZE = 64 * 1024;
+
+    struct Slot {
+        const char* data = nullptr; // nullptr = empty
+        uint32_t size = 0;
+        uint32_t hash = 0;
+    };
+
+    static uint32_t hashOf(string_view s) // FNV-1a
+    {
+        uint32_t h = 2166136261u;
+        for (unsigned char c : s) h = (h ^ c) * 16777619u;
+        return h;
+    }
+
+    void place(const Slot& entry)
+    {
+        size_t mask = slots.size() - 1;
+        size_t i = entry.hash & mask;
+        while (slots[i].data) i = (i + 1) & mask;
+        slots[i] = entry;
+    }
+
+    void grow(size_t capacity)
+    {
+        vector<Slot> old(capacity);
+        old.swap(slots);
+        for (const Slot& entry : old)
+            if (entry.data) place(entry);
+    }
+
+    string_view store(string_view s)
+    {
+        if (s.size() > BLOCK_SIZE / 4) { // a long one gets a block of its own
+            big.emplace_back(new char[s.size()]);
+            memcpy(big.back().get(), s.data(), s.size());
+            return string_view(big.back().get(), s.size());
+        }
+        if (blocks.empty() || used + s.size() > BLOCK_SIZE) {
+            blocks.emplace_back(new char[BLOCK_SIZE]);
+            used = 0;
+        }
+        char* at = blocks.back().get() + used;
+        memcpy(at, s.data(), s.size());
+        used += s.size();
+        return string_view(at, s.size());
+    }
+
+    mutable mutex mtx;
+    vector<Slot> slots; // size is a power of two, at most half full
+    size_t count = 0;
+    vector<unique_ptr<char[]>> blocks, big;
+    size_t used = 0; // bytes taken in blocks.back()
+};
+
+StringTable names;
+
+// A log line built from fragments in a buffer that keeps its capacity, so a
+// line reused across ticks is formatted without allocating once it is warm
+class LogLine
+{
+public:
+    explicit LogLine(size_t capacity = 160) { text.reserve(capacity); }
+
+    LogLine& clear() { text.clear(); return *this; }
+    LogLine& operator<<(string_view s) { text.append(s.data(), s.size()); return *this; }
+    LogLine& operator<<(long n)
+    {
+        char buf[24];
+        auto end = to_chars(buf, buf + sizeof(buf), n).ptr;
+        text.append(buf, end - buf);
+        return *this;
+    }
+
+    operator string_view() const { return text; }
+
+private:
+    string text;
+};
+
 struct SpeedRule {
     double minSpeed;
     double maxSpeed;
@@ -71,8 +396,8 @@ struct SpeedRule {
 };
 
 struct Aircraft {
-    string id;
-    string airline;
+    string_view id;      // interned in names
+    string_view airline; // interned in names
     AircraftType type;
     FlightPhase phase;
     double currentSpeed;
@@ -80,9 +405,10 @@ struct Aircraft {
     Direction direction;
     bool hasAVN;
     RunwayID assignedRunway;
+    RunwayID queuedRunway; // runway whose queue currently holds this aircraft
     bool hasFault;
     int priority;
-    string scheduledTimeStr;
+    string_view scheduledTimeStr; // interned in names
     int scheduledMinutes;
     int mappedSimSecond;
     time_t lastPhaseChange;
@@ -91,12 +417,15 @@ struct Aircraft {
     double fuelPercentage; // Fuel level (0-100%)
     bool hadLowFuel; // Tracks if low fuel emergency occurred
     int AVNcount = 0; //new: track the count of avns issued 
+    int phaseWakeTick = -1; // simulation second the phase timer fires, -1 = none (guarded by the TimerWheel)
+    bool terminal = false; // counted in AirControlX::terminalFlights (guarded by terminalMutex)
+    bool retired = false;  // moved to AirControlX::history, slot can be reused (guarded by displayMutex)
 
 
-    Aircraft() : assignedRunway(static_cast<RunwayID>(-1)), waitTime(0.0), fuelPercentage(100.0), hadLowFuel(false) {}
+    Aircraft() : assignedRunway(NO_RUNWAY), queuedRunway(NO_RUNWAY), waitTime(0.0), fuelPercentage(100.0), hadLowFuel(false) {}
 
-    // For display purposes
-    string getPhaseString() const {
+    // For display purposes, views of static names so display loops do not build strings
+    string_view getPhaseString() const {
         switch(phase) {
             case HOLDING: return "Holding";
             case APPROACH: return "Approach";
@@ -110,7 +439,7 @@ struct Aircraft {
         }
     }
 
-    string getTypeString() const {
+    string_view getTypeString() const {
         switch(type) {
             case COMMERCIAL: return "Commercial";
             case CARGO: return "Cargo";
@@ -119,31 +448,163 @@ struct Aircraft {
         }
     }
 
-    string getRunwayString() const {
-        switch(assignedRunway) {
-            case RWY_A: return "RWY-A";
-            case RWY_B: return "RWY-B";
-            case RWY_C: return "RWY-C";
-            default: return "None";
-        }
+    string_view getRunwayString() const {
+        if (assignedRunway >= 0 && assignedRunway < static_cast<int>(runwayConfigs.size()))
+            return runwayConfigs[assignedRunway].name;
+        return "None";
     }
 };
 
-struct Runway {
-    RunwayID id;
-    atomic<bool> isOccupied;
-    mutex mtx;
-    condition_variable cv;
-    Aircraft* currentAircraft;
+// What is kept of a flight after it is retired, enough for the summary and the log
+struct FlightRecord {
+    string_view id;      // interned in names
+    string_view airline;
+    AircraftType type;
+    Direction direction;
+    FlightPhase finalPhase;
+    RunwayID runway;
+    bool hadFault;
+    bool hadLowFuel;
+    int AVNcount;
+    double waitTime;
+    int retiredAt; // simulation second
+};
 
-    string getName() const {
-        switch(id) {
-            case RWY_A: return "RWY-A (Arrivals)";
-            case RWY_B: return "RWY-B (Departures)";
-            case RWY_C: return "RWY-C (Cargo/Emergency)";
-            default: return "Unknown";
+// Starting state for a new flight once its plan fields (id, airline, type,
+// direction, priority, time) are filled in. seed feeds rand_r so flight
+// plans can be set up on several threads at once.
+void initFlightDefaults(Aircraft& ac, time_t now, unsigned& seed)
+{
+    ac.phase = (ac.direction == NORTH || ac.direction == SOUTH) ? HOLDING : AT_GATE;
+    ac.currentSpeed = (ac.phase == HOLDING) ? 400 + (rand_r(&seed) % 201) : 0;
+    ac.isEmergency = (ac.type == EMERGENCY);
+    ac.hasAVN = false;
+    ac.hasFault = false;
+    ac.lastPhaseChange = now;
+    ac.queueEntryTime = now;
+    ac.fuelPercentage = (ac.direction == NORTH || ac.direction == SOUTH) ?
+        (70 + (rand_r(&seed) % 31)) : 100.0;  // b/w 70-100 for arrivals, 100 for departures
+    ac.hadLowFuel = false;
+}
+
+// Sort on several threads: sort equal slices in parallel, then merge neighbouring
+// slices pairwise (also in parallel) until one run is left. Small inputs just use std::sort.
+template <typename T, typename Compare>
+void parallelSort(vector<T>& items, Compare comp, unsigned threads = thread::hardware_concurrency())
+{
+    const size_t MIN_SLICE = 4096; // below this a thread costs more than it saves
+    size_t slices = min<size_t>(max(1u, threads), items.size() / MIN_SLICE);
+    if (slices < 2) {
+        sort(items.begin(), items.end(), comp);
+        return;
+    }
+
+    vector<size_t> bounds;
+    for (size_t i = 0; i <= slices; i++) bounds.push_back(items.size() * i / slices);
+
+    vector<thread> workers;
+    for (size_t i = 0; i < slices; i++) {
+        workers.emplace_back([&, i]() { sort(items.begin() + bounds[i], items.begin() + bounds[i + 1], comp); });
+    }
+    for (auto& worker : workers) worker.join();
+
+    while (bounds.size() > 2) {
+        vector<size_t> merged{0};
+        workers.clear();
+        for (size_t i = 0; i + 2 < bounds.size(); i += 2) {
+            size_t lo = bounds[i], mid = bounds[i + 1], hi = bounds[i + 2];
+            workers.emplace_back([&, lo, mid, hi]() { inplace_merge(items.begin() + lo, items.begin() + mid, items.begin() + hi, comp); });
+            merged.push_back(hi);
+        }
+        if (merged.back() != bounds.back()) merged.push_back(bounds.back()); // odd slice out waits for the next round
+        for (auto& worker : workers) worker.join();
+        bounds.swap(merged);
+    }
+}
+
+// Hierarchical timing wheel on simulation seconds. Level 0 has one slot per
+// second for the next 64 seconds, level 1 one slot per 64 seconds, level 2 one
+// per 4096; timers move down a level as their slot comes up. Each aircraft has
+// at most one live timer (Aircraft::phaseWakeTick), older entries are dropped
+// when they fire. Safe to call from the tick loop and the runway threads.
+class TimerWheel
+{
+public:
+    static const int SLOTS = 64;
+    static const int LEVELS = 3;
+
+    TimerWheel()
+    {
+        // slots keep their capacity when cleared, so after warming up the wheel stops allocating
+        for (auto& level : slots)
+            for (auto& slot : level) slot.reserve(8);
+    }
+
+    // Fire at tick, unless the aircraft already has an earlier timer
+    void schedule(Aircraft* aircraft, int tick)
+    {
+        lock_guard<mutex> lock(mtx);
+        if (tick <= current) tick = current + 1; // overdue: next tick
+        if (aircraft->phaseWakeTick != -1 && aircraft->phaseWakeTick <= tick) return;
+        aircraft->phaseWakeTick = tick;
+        place(aircraft, tick);
+    }
+
+    // Drop the aircraft's timer, its wheel entry is skipped when the slot comes up
+    void cancel(Aircraft* aircraft)
+    {
+        lock_guard<mutex> lock(mtx);
+        aircraft->phaseWakeTick = -1;
+    }
+
+    // Move the wheel up to tick and append every aircraft whose timer fired
+    void advance(int tick, vector<Aircraft*>& due)
+    {
+        lock_guard<mutex> lock(mtx);
+        while (current < tick) {
+            current++;
+            // bring the next block of timers down a level when its turn comes
+            if ((current & (SLOTS * SLOTS - 1)) == 0) cascade(2, (current >> 12) & (SLOTS - 1));
+            if ((current & (SLOTS - 1)) == 0) cascade(1, (current >> 6) & (SLOTS - 1));
+
+            vector<Entry>& slot = slots[0][current & (SLOTS - 1)];
+            for (const Entry& entry : slot) {
+                if (entry.aircraft->phaseWakeTick != entry.tick) continue; // rescheduled since
+                entry.aircraft->phaseWakeTick = -1;
+                due.push_back(entry.aircraft);
+            }
+            slot.clear();
         }
     }
+
+private:
+    struct Entry {
+        Aircraft* aircraft;
+        int tick;
+    };
+
+    // tick >= current; a cascade can hand back a timer due on this very tick
+    void place(Aircraft* aircraft, int tick)
+    {
+        int delta = tick - current;
+        if (delta < SLOTS) slots[0][tick & (SLOTS - 1)].push_back({aircraft, tick});
+        else if (delta < SLOTS * SLOTS) slots[1][(tick >> 6) & (SLOTS - 1)].push_back({aircraft, tick});
+        else slots[2][(tick >> 12) & (SLOTS - 1)].push_back({aircraft, tick});
+    }
+
+    void cascade(int level, int index)
+    {
+        cascading.clear();
+        cascading.swap(slots[level][index]); // the slot takes over cascading's buffer
+        for (const Entry& entry : cascading) {
+            if (entry.aircraft->phaseWakeTick == entry.tick) place(entry.aircraft, entry.tick);
+        }
+    }
+
+    mutex mtx;
+    vector<Entry> slots[LEVELS][SLOTS];
+    vector<Entry> cascading;
+    int current = 0;
 };
 
 // Comparator for priority queue
@@ -156,79 +617,438 @@ struct AircraftComparator {
     }
 };
 
+// A runway's queue: a binary heap ordered by AircraftComparator (what priority_queue
+// did), plus a version that every change bumps. Writers hold Runway::queueMutex as
+// before; the version can be read without it, see QueueSnapshot.
+class RunwayQueue {
+public:
+    bool empty() const { return items.empty(); }
+    size_t size() const { return items.size(); }
+    Aircraft* top() const { return items.front(); }
+
+    void push(Aircraft* aircraft) {
+        items.push_back(aircraft);
+        push_heap(items.begin(), items.end(), AircraftComparator());
+        changed();
+    }
+
+    void pop() {
+        pop_heap(items.begin(), items.end(), AircraftComparator());
+        items.pop_back();
+        changed();
+    }
+
+    // Take aircraft out from anywhere in the queue, O(n); returns false if it was not queued
+    bool remove(const Aircraft* aircraft) {
+        auto it = find(items.begin(), items.end(), aircraft);
+        if (it == items.end()) return false;
+        *it = items.back();
+        items.pop_back();
+        make_heap(items.begin(), items.end(), AircraftComparator());
+        changed();
+        return true;
+    }
+
+    // Add many at once, O(n) instead of one push each
+    void pushAll(const vector<Aircraft*>& aircraft) {
+        items.insert(items.end(), aircraft.begin(), aircraft.end());
+        make_heap(items.begin(), items.end(), AircraftComparator());
+        changed();
+    }
+
+    unsigned long version() const { return changes.load(memory_order_acquire); }
+
+    // The heap itself: items[0] pops next, the rest are in heap order (hold queueMutex)
+    const vector<Aircraft*>& heap() const { return items; }
+
+private:
+    void changed() { changes.fetch_add(1, memory_order_release); }
+
+    vector<Aircraft*> items;
+    atomic<unsigned long> changes{0};
+};
+
+struct Runway {
+    RunwayID id;
+    RunwayConfig config;
+    atomic<bool> isOccupied;
+    mutex mtx;
+    condition_variable cv;
+    Aircraft* currentAircraft;
+    atomic<Aircraft*> claimed{nullptr}; // popped from the queue, waiting for the runway to be free
+
+    // each runway owns the queue of flights routed to it
+    RunwayQueue queue;
+    mutable mutex queueMutex;
+
+    // preformatted once, log lines and displays only append them
+    string fullName; // "RWY-A (Arrivals)"
+    string logTag;   // " (RWY-A)" after a flight id in phase log lines
+
+    const string& getName() const {
+        return fullName;
+    }
+};
+
 class AirControlX {
 public: //delcaring these publically so that the stupid sfml windows can access this data
-    vector<Aircraft> flights;
-    array<Runway, MAX_RUNWAYS> runways;
+    // Flights not admitted yet: filled by the input screens and plan loaders, sorted by
+    // scheduleFlights, and taken from planNext on as their mapped second comes near
+    vector<Aircraft> plan;
+    size_t planNext = 0;
+    // Admitted flights. A deque never moves its elements, so the Aircraft& held by radar
+    // threads, runway queues and the timer wheel stay valid while it grows, and a retired
+    // flight's slot is reused by the next admission.
+    deque<Aircraft> flights;
+    vector<Aircraft*> activeFlights; // admitted and not retired, what the views list (guarded by displayMutex)
+    vector<vector<Aircraft*>> admitBuckets; // admitFlights() scratch, one per runway
+    vector<size_t> admittedSlots;           // admitFlights() scratch
+    deque<Runway> runways; // deque so Runway (mutex, atomic) never has to move
+    array<array<vector<RunwayID>, 4>, 3> routes; // [type][direction] -> eligible runways, built once from the topology
+    atomic<unsigned> routeCursor[3][4]; // round robin position in each routes cell
     atomic<int> simulationTime;
+    TimerWheel phaseTimers; // wakes an aircraft only when its phase can change
+    long phaseChecks = 0;   // updateFlightPhase calls made by the tick loop
+    atomic<int> terminalFlights{0}; // flights with nothing left to do, see isTerminal()
+    mutex terminalMutex;
+    vector<Aircraft*> retireCandidates; // became terminal, waiting for retireFlights() (guarded by terminalMutex)
+    vector<Aircraft*> retireBatch, retireLater; // retireFlights() scratch, kept to reuse their capacity
+
+    // Retirement: finished flights leave the simulation, see retireFlights()
+    vector<FlightRecord> history;  // retired flights, in retirement order
+    mutex radarExitMutex;
+    condition_variable radarWake;  // waited on with displayMutex: a flight retired or the run ended
+    vector<size_t> exitedSlots;    // slots whose radar thread has returned (guarded by radarExitMutex)
+    vector<size_t> joinSlots;      // retireFlights() scratch, swapped with exitedSlots
+    vector<size_t> freeSlots;      // slots in flights that admitFlight can reuse
     mutable mutex logMutex; //new mutable so that sfml walay functions can access it
     mutable mutex displayMutex; //new for display
     ofstream logFile;
-
-    vector<string> consoleOutput; //new for console output
+    EventSink events; // columnar copy of the events in log.txt, for offline analysis
+
+    // Tick loop timing, only touched from the thread running startSimulation
+    thread::id tickThread;
+    LatencyHistogram tickWork, tickDrift, lockWait;
+    LatencyHistogram phaseCost[CRUISE + 1]; // updateFlightPhase cost by the phase it started in
+    long runwayLockMisses = 0; // updateFlightPhase found the runway locked and skipped the flight
+    SlowTickTracer tickTrace;
+    unsigned long tickAllocations = 0; // heap allocations made by tick work
+    int ticksAllocating = 0, lastAllocatingTick = 0;
+
+    static const size_t CONSOLE_LINES = 64;
+    array<string, CONSOLE_LINES> consoleOutput; //new for console output, ring of the latest lines (guarded by logMutex)
+    size_t consoleCount = 0; // lines logged so far
+    LogLine phaseLine;       // tick loop's buffer for phase log lines
     atomic<bool> simulationComplete{false}; //new for ending screen when program ends
-
-    // Priority queues for each runway
-    priority_queue<Aircraft*, vector<Aircraft*>, AircraftComparator> arrivalQueue;
-    priority_queue<Aircraft*, vector<Aircraft*>, AircraftComparator> departureQueue;
-    priority_queue<Aircraft*, vector<Aircraft*>, AircraftComparator> cargoEmergencyQueue;
-    mutable mutex arrivalQueueMutex;
-    mutable mutex departureQueueMutex;
-    mutable mutex cargoQueueMutex;
+    atomic<unsigned long> viewVersion{0}; // bumped when what the views show changes: after every tick and log line
 
     // Thread management
-    vector<thread> flightThreads;
+    vector<thread> flightThreads; // by slot in flights
     vector<thread> runwayThreads;
     atomic<bool> simulationRunning;
 
     //for child process
-    int pipe_fd[2]; // Pipe for AVN Generator communication
+    AvnSupervisor avnGenerator; // the avn_generator child, restarted if it dies
+    AvnEmitter avnEmitter; // radar threads queue AVN lines here, its writer thread feeds the generator
 
 
 public:
-    AirControlX() : simulationTime(0), simulationRunning(false) {
+    // openSinks = false leaves log.txt and events.evc alone (the frame bench
+    // builds one, and must not wipe the files of the last real run)
+    explicit AirControlX(bool openSinks = true) : simulationTime(0), simulationRunning(false) {
+        // Load runway topology, falling back to the original three runways
+        string error;
+        if (loadRunwayConfig(RUNWAY_CONFIG_FILE, runwayConfigs, error)) {
+            cout << "[ATC] Loaded " << runwayConfigs.size() << " runways from " << RUNWAY_CONFIG_FILE << endl;
+        } else {
+            cerr << "[ATC] Runway config not used (" << error << "), using default 3 runways" << endl;
+            runwayConfigs = defaultRunwayConfig();
+        }
+
         // Initialize runways
-        runways[RWY_A].id = RWY_A;
-        runways[RWY_B].id = RWY_B;
-        runways[RWY_C].id = RWY_C;
-        runways[RWY_A].isOccupied = false;
-        runways[RWY_B].isOccupied = false;
-        runways[RWY_C].isOccupied = false;
-        runways[RWY_A].currentAircraft = nullptr;
-        runways[RWY_B].currentAircraft = nullptr;
-        runways[RWY_C].currentAircraft = nullptr;
+        for (size_t i = 0; i < runwayConfigs.size(); i++) {
+            runways.emplace_back();
+            Runway& runway = runways.back();
+            runway.id = static_cast<RunwayID>(i);
+            runway.config = runwayConfigs[i];
+            runway.isOccupied = false;
+            runway.currentAircraft = nullptr;
+            runway.fullName = runway.config.name + " (" + runway.config.role + ")";
+            runway.logTag = " (" + runway.config.name + ")";
+        }
+
+        for (auto& line : consoleOutput) line.reserve(160);
 
+        // Precompute routing so picking a runway never scans the runway list
+        for (int t = 0; t < 3; t++) {
+            for (int d = 0; d < 4; d++) {
+                routeCursor[t][d] = 0;
+                for (const auto& runway : runways) {
+                    if (runway.config.allows(static_cast<AircraftType>(t), static_cast<Direction>(d)))
+                        routes[t][d].push_back(runway.id);
+                }
+            }
+        }
+
+        if (!openSinks) return;
         logFile.open("log.txt", ios::out);
         if (!logFile.is_open()) {
             cerr << "Failed to open log file!" << endl;
             exit(1); // Exit if log file can't be opened
         }
+
+        vector<string> runwayNames;
+        for (const auto& runway : runways) runwayNames.push_back(runway.config.name);
+        vector<string> phaseNames;
+        for (int p = HOLDING; p <= CRUISE; p++) {
+            Aircraft phaseOnly;
+            phaseOnly.phase = static_cast<FlightPhase>(p);
+            phaseNames.emplace_back(phaseOnly.getPhaseString());
+        }
+        if (!events.open(EVENT_FILE, runwayNames, phaseNames)) {
+            cerr << "[ATC] Failed to open " << EVENT_FILE << ", events go to log.txt only" << endl;
+        }
     }
 
     ~AirControlX() {
+        events.close();
         if (logFile.is_open()) {
             logFile.close();
         }
     }
 
-    void logEvent(const string& message) {
+    void logEvent(string_view message) {
+        bool timed = this_thread::get_id() == tickThread;
+        int64_t waitStart = timed ? trace_now_us() : 0;
         lock_guard<mutex> lock(logMutex);
+        if (timed) noteLockWait("wait logMutex", waitStart);
         logFile << message << endl;
         cout << message << endl;
-        consoleOutput.push_back(message); //new: we need the message for the console as well
+        // new: we need the message for the console as well; the ring reuses its strings
+        consoleOutput[consoleCount++ % CONSOLE_LINES].assign(message.data(), message.size());
+        viewVersion++;
+    }
+
+    // Time spent waiting for a lock on the tick thread
+    void noteLockWait(const char* name, int64_t waitStart) {
+        int64_t waited = trace_now_us() - waitStart;
+        lockWait.add(waited);
+        tickTrace.span(name, waitStart, waited);
+    }
+
+    // log a phase change ("[PHASE] <id>[ (<runway>)]<what>") and record it as a typed event.
+    // Only called from the tick loop, which owns phaseLine.
+    void logPhase(Aircraft& aircraft, string_view what, const Runway* runway = nullptr) {
+        phaseLine.clear() << "[PHASE] " << aircraft.id;
+        if (runway) phaseLine << runway->logTag;
+        phaseLine << what;
+        logEvent(phaseLine);
+        events.record(EV_PHASE, aircraft.id, aircraft.assignedRunway, aircraft.phase, static_cast<int32_t>(aircraft.currentSpeed));
+        updateTerminalState(aircraft);
+    }
+
+    // Nothing left to simulate: cruising, towed, or an arrival at its gate
+    static bool isTerminal(const Aircraft& ac) {
+        return ac.phase == CRUISE || ac.hasFault ||
+               (ac.phase == AT_GATE && (ac.direction == NORTH || ac.direction == SOUTH));
+    }
+
+    // Keep terminalFlights in step with this aircraft, call after any phase or fault change.
+    // Counts both ways so a state that is left again is taken back off.
+    void updateTerminalState(Aircraft& aircraft) {
+        lock_guard<mutex> lock(terminalMutex);
+        bool terminal = isTerminal(aircraft);
+        if (terminal == aircraft.terminal) return;
+        aircraft.terminal = terminal;
+        if (terminal) {
+            terminalFlights++;
+            retireCandidates.push_back(&aircraft);
+        } else {
+            terminalFlights--;
+        }
+    }
+
+    // Put a flight in a retired slot if one is free, otherwise append it (hold displayMutex)
+    size_t admitFlight(const Aircraft& planned) {
+        if (freeSlots.empty()) {
+            flights.push_back(planned);
+            return flights.size() - 1;
+        }
+        size_t slot = freeSlots.back();
+        freeSlots.pop_back();
+        flights[slot] = planned;
+        return slot;
+    }
+
+    // Planned flights are routed by scheduleFlights. One bound for an immediate runway
+    // is dispatched as soon as it is queued, so it does not wait for its slot to join.
+    bool admissionDue(const Aircraft& planned, int upTo) const {
+        return planned.mappedSimSecond <= upTo || runways[planned.queuedRunway].config.policy == IMMEDIATE;
+    }
+
+    // Bring the planned flights due by upTo into the simulation: a slot, a runway queue
+    // and, once the run has started, a radar thread and a first look on the next tick.
+    // Each runway's queue takes its new flights in one make_heap.
+    void admitFlights(int upTo) {
+        if (planNext == plan.size() || !admissionDue(plan[planNext], upTo)) return;
+        admitBuckets.resize(runways.size());
+        time_t now = time(nullptr);
+        {
+            lock_guard<mutex> lock(displayMutex);
+            while (planNext < plan.size() && admissionDue(plan[planNext], upTo)) {
+                size_t slot = admitFlight(plan[planNext++]);
+                Aircraft& flight = flights[slot];
+                flight.queueEntryTime = now; // Record queue entry time
+                admitBuckets[flight.queuedRunway].push_back(&flight);
+                activeFlights.push_back(&flight);
+                admittedSlots.push_back(slot);
+            }
+        }
+
+        for (auto& runway : runways) {
+            vector<Aircraft*>& bucket = admitBuckets[runway.id];
+            if (bucket.empty()) continue;
+            lock_guard<mutex> lock(runway.queueMutex);
+            runway.queue.pushAll(bucket); // keeps anything already queued
+            bucket.clear();
+        }
+        if (simulationRunning) { // before the run, startSimulation starts them all
+            for (size_t slot : admittedSlots) {
+                startRadar(slot);
+                phaseTimers.schedule(&flights[slot], simulationTime + 1);
+                updateTerminalState(flights[slot]);
+            }
+        }
+        admittedSlots.clear();
+    }
+
+    void startRadar(size_t slot) {
+        if (slot >= flightThreads.size()) flightThreads.resize(slot + 1);
+        flightThreads[slot] = thread(&AirControlX::radarMonitor, this, ref(flights[slot]), slot);
+    }
+
+    // True if a runway holds this aircraft, or might: a runway whose lock is busy
+    // (its controller sleeps through the operation holding it) counts as maybe, and
+    // so does a runway whose controller has popped the aircraft and waits to dispatch it
+    bool mayBeOnRunway(const Aircraft& aircraft) {
+        for (auto& runway : runways) {
+            unique_lock<mutex> lock(runway.mtx, try_to_lock);
+            if (!lock.owns_lock() || runway.currentAircraft == &aircraft || runway.claimed == &aircraft) return true;
+        }
+        return false;
+    }
+
+    // Move terminal flights out of the simulation: keep a FlightRecord, drop their
+    // timer, take them off activeFlights and wake their radar threads so they return.
+    // A flight still queued or holding a runway waits for a later tick. Only radar
+    // threads that have said they returned are joined, so the join never waits, and
+    // their slots go back to the pool.
+    void retireFlights() {
+        {
+            lock_guard<mutex> lock(radarExitMutex);
+            joinSlots.swap(exitedSlots);
+        }
+        for (size_t slot : joinSlots) {
+            flightThreads[slot].join();
+            freeSlots.push_back(slot);
+        }
+        joinSlots.clear();
+
+        retireBatch.clear();
+        {
+            lock_guard<mutex> lock(terminalMutex);
+            if (retireCandidates.empty()) return;
+            retireBatch.swap(retireCandidates);
+        }
+
+        retireLater.clear();
+        size_t retiring = 0; // the first ones in retireBatch
+        for (Aircraft* aircraft : retireBatch) {
+            if (!aircraft->terminal || aircraft->retired) continue;
+            if (aircraft->queuedRunway != NO_RUNWAY || mayBeOnRunway(*aircraft)) {
+                retireLater.push_back(aircraft);
+                continue;
+            }
+            phaseTimers.cancel(aircraft);
+            retireBatch[retiring++] = aircraft;
+        }
+
+        if (retiring > 0) {
+            int64_t waitStart = trace_now_us();
+            {
+                lock_guard<mutex> lock(displayMutex);
+                noteLockWait("wait displayMutex", waitStart);
+                for (size_t i = 0; i < retiring; i++) {
+                    Aircraft* aircraft = retireBatch[i];
+                    if (aircraft->retired) continue; // listed twice
+                    aircraft->retired = true;
+                    history.push_back({aircraft->id, aircraft->airline, aircraft->type, aircraft->direction, aircraft->phase,
+                                       aircraft->assignedRunway, aircraft->hasFault, aircraft->hadLowFuel,
+                                       aircraft->AVNcount, aircraft->waitTime, simulationTime});
+                }
+                activeFlights.erase(remove_if(activeFlights.begin(), activeFlights.end(),
+                                              [](const Aircraft* flight) { return flight->retired; }),
+                                    activeFlights.end());
+            }
+            radarWake.notify_all(); // their radar threads return now, not at their next look
+        }
+
+        if (!retireLater.empty()) {
+            lock_guard<mutex> lock(terminalMutex);
+            retireCandidates.insert(retireCandidates.end(), retireLater.begin(), retireLater.end());
+        }
     }
 
-     //new: getter for console output
-    const vector<string>& getConsoleOutput() const 
+     //new: getter for console output, the latest CONSOLE_LINES lines oldest first
+    vector<string> getConsoleOutput() const 
     {
-        return consoleOutput;
+        lock_guard<mutex> lock(logMutex);
+        vector<string> lines;
+        size_t first = consoleCount > CONSOLE_LINES ? consoleCount - CONSOLE_LINES : 0;
+        for (size_t i = first; i < consoleCount; i++) lines.push_back(consoleOutput[i % CONSOLE_LINES]);
+        return lines;
     }
 
     //get the most recent message
     string getLatestMessage() const
     {
         lock_guard<mutex> lock(logMutex);
-        return consoleOutput.empty() ? "" : consoleOutput.back();
+        return consoleCount == 0 ? "" : consoleOutput[(consoleCount - 1) % CONSOLE_LINES];
+    }
+
+    // Copy the most recent message into out only if something was logged after
+    // the first seen lines; returns the new count to pass next time
+    size_t latestMessageSince(size_t seen, string& out) const
+    {
+        lock_guard<mutex> lock(logMutex);
+        if (consoleCount != seen && consoleCount > 0) out.assign(consoleOutput[(consoleCount - 1) % CONSOLE_LINES]);
+        return consoleCount;
+    }
+
+    // Pick a runway for this type/direction, spreading load round robin over the eligible ones
+    RunwayID routeFor(AircraftType type, Direction dir) {
+        const vector<RunwayID>& eligible = routes[type][dir];
+        if (eligible.empty()) return NO_RUNWAY;
+        return eligible[routeCursor[type][dir]++ % eligible.size()];
+    }
+
+    void enqueueAircraft(Aircraft& aircraft, RunwayID id) {
+        Runway& runway = runways[id];
+        lock_guard<mutex> lock(runway.queueMutex);
+        runway.queue.push(&aircraft);
+        aircraft.queuedRunway = id;
+    }
+
+    // Remove aircraft from whichever runway queue holds it, returns true if it was queued
+    bool removeFromQueue(Aircraft& aircraft) {
+        RunwayID id = aircraft.queuedRunway;
+        if (id == NO_RUNWAY) return false;
+
+        Runway& runway = runways[id];
+        lock_guard<mutex> lock(runway.queueMutex);
+        bool removed = runway.queue.remove(&aircraft);
+        aircraft.queuedRunway = NO_RUNWAY;
+        return removed;
     }
     
 
@@ -284,8 +1104,10 @@ public:
         return rule;
     }
 
-    void monitorSpeed(Aircraft& aircraft) {
-        if (aircraft.phase == AT_GATE) return;
+    // Returns the length of the AVN line written to avnLine, 0 if none was issued.
+    // The caller emits it after letting go of displayMutex.
+    size_t monitorSpeed(Aircraft& aircraft, char (&avnLine)[AVN_LINE_MAX]) {
+        if (aircraft.phase == AT_GATE) return 0;
 
         SpeedRule rule = getSpeedRule(aircraft.phase);
 
@@ -297,14 +1119,20 @@ public:
                 aircraft.AVNcount++; //increment avn count
                 TotalAVNs++;
 
-                string msg = "[SPEED MONITOR] AVN Issued for " + aircraft.id + ": " +
-                             rule.violationCriteria + " (" + to_string(aircraft.currentSpeed) + " km/h)";
+                char speed[32];
+                snprintf(speed, sizeof(speed), "%f", aircraft.currentSpeed);
+                LogLine msg;
+                msg << "[SPEED MONITOR] AVN Issued for " << aircraft.id << ": " <<
+                       rule.violationCriteria << " (" << speed << " km/h)";
                 logEvent(msg);
+                events.record(EV_AVN, aircraft.id, aircraft.assignedRunway, aircraft.phase, static_cast<int32_t>(aircraft.currentSpeed));
 
                 //formulate space separated string for AVN generator
-                string AVNissued = aircraft.id + " " + aircraft.airline + " " + to_string(aircraft.type)  + " " + to_string(aircraft.currentSpeed) + " " + to_string(aircraft.phase) + " " + to_string(rule.minSpeed) + " " +to_string(rule.maxSpeed) + "\n";
-                // write AVN details to pipe
-                write(this->pipe_fd[1], AVNissued.c_str(), AVNissued.size());
+                int n = snprintf(avnLine, sizeof(avnLine), "%.*s %.*s %ld %s %ld %f %f\n",
+                                 int(aircraft.id.size()), aircraft.id.data(), int(aircraft.airline.size()), aircraft.airline.data(),
+                                 long(aircraft.type), speed, long(aircraft.phase), rule.minSpeed, rule.maxSpeed);
+                if (n <= 0) return 0;
+                return min(static_cast<size_t>(n), sizeof(avnLine) - 1); // emit() ends a cut line with '\n'
             }
 
             //reset avn flag
@@ -314,12 +1142,52 @@ public:
             }
             
         }
+        return 0;
+    }
+
+    // Seconds until updateFlightPhase can next do something for this aircraft, or
+    // -1 if nothing will happen until something else (dispatch, emergency) wakes it.
+    // Mirrors the dwell times in updateFlightPhase; waking early is harmless.
+    int phaseCheckDelay(const Aircraft& aircraft) const {
+        if (aircraft.hasFault || aircraft.assignedRunway < 0 || aircraft.assignedRunway >= static_cast<int>(runways.size())) {
+            return -1; // waits for a runway
+        }
+        bool arrivalPath = aircraft.direction == NORTH || aircraft.direction == SOUTH || aircraft.isEmergency;
+        int dwell;
+        switch (aircraft.phase) {
+            case LANDING:
+            case TAKEOFF_ROLL:
+                return 1; // speed changes every second
+            case HOLDING:
+                dwell = arrivalPath ? 5 : 20;
+                break;
+            case APPROACH:
+            case TAXI:
+            case CLIMB:
+                dwell = 20;
+                break;
+            case AT_GATE:
+                if (aircraft.direction == EAST || aircraft.direction == WEST) {
+                    dwell = 20;
+                    break;
+                }
+                return -1; // arrivals are done at the gate
+            default:
+                return -1; // cruising
+        }
+        int elapsed = static_cast<int>(difftime(time(nullptr), aircraft.lastPhaseChange));
+        return max(1, dwell + 1 - elapsed);
+    }
+
+    void schedulePhaseCheck(Aircraft& aircraft) {
+        int delay = phaseCheckDelay(aircraft);
+        if (delay > 0) phaseTimers.schedule(&aircraft, simulationTime + delay);
     }
 
     void updateFlightPhase(Aircraft& aircraft) {
         time_t now = time(nullptr);
 
-        if (aircraft.hasFault || aircraft.assignedRunway < 0 || aircraft.assignedRunway >= MAX_RUNWAYS) {
+        if (aircraft.hasFault || aircraft.assignedRunway < 0 || aircraft.assignedRunway >= static_cast<int>(runways.size())) {
             return; // Invalid runway ID
         }
 
@@ -331,14 +1199,14 @@ public:
                 if (difftime(now, aircraft.lastPhaseChange) > 5) {
                     aircraft.phase = APPROACH;
                     aircraft.lastPhaseChange = now;
-                    logEvent("[PHASE] " + aircraft.id + " moved to APPROACH.");
+                    logPhase(aircraft, " moved to APPROACH.");
                 }
             } else if (aircraft.phase == APPROACH) {
                 aircraft.currentSpeed = 240 + (rand() % 51); // 240-290 km/h
                 if (difftime(now, aircraft.lastPhaseChange) > 20) {
                     aircraft.phase = LANDING;
                     aircraft.lastPhaseChange = now;
-                    logEvent("[PHASE] " + aircraft.id + " moved to LANDING.");
+                    logPhase(aircraft, " moved to LANDING.");
                 }
             }
             return;
@@ -348,12 +1216,14 @@ public:
         Runway& runway = runways[aircraft.assignedRunway];
         unique_lock<mutex> lock(runway.mtx, try_to_lock);
         if (!lock.owns_lock()) {
+            runwayLockMisses++;
+            tickTrace.span("runway lock busy", trace_now_us(), 0, aircraft.id);
             return;
         }
 
              //new : check emergency and runway first
-             //fallback phase for an aircraft on runway c that had a random direction so random phase
-             if (aircraft.isEmergency || aircraft.assignedRunway == RWY_C) 
+             //fallback phase for an aircraft on a mixed use runway that had a random direction so random phase
+             if (aircraft.isEmergency || runway.config.mixedUse()) 
              {
                 switch (aircraft.phase) {
                     case HOLDING:
@@ -361,7 +1231,7 @@ public:
                         if (difftime(now, aircraft.lastPhaseChange) > 20) {
                             aircraft.phase = APPROACH;
                             aircraft.lastPhaseChange = now;
-                            logEvent("[PHASE] " + aircraft.id + " (RWY-C) moved to APPROACH.");
+                            logPhase(aircraft, " moved to APPROACH.", &runway);
                         }
                         break;
                     case APPROACH:
@@ -369,7 +1239,7 @@ public:
                         if (difftime(now, aircraft.lastPhaseChange) > 20) {
                             aircraft.phase = LANDING;
                             aircraft.lastPhaseChange = now;
-                            logEvent("[PHASE] " + aircraft.id + " (RWY-C) moved to LANDING.");
+                            logPhase(aircraft, " moved to LANDING.", &runway);
                         }
                         break;
                     case LANDING:
@@ -378,7 +1248,7 @@ public:
                             aircraft.phase = TAXI;
                             aircraft.currentSpeed = 15 + (rand() % 16);
                             aircraft.lastPhaseChange = now;
-                            logEvent("[PHASE] " + aircraft.id + " (RWY-C) moved to TAXI.");
+                            logPhase(aircraft, " moved to TAXI.", &runway);
                         }
                         break;
                     case TAXI:
@@ -386,7 +1256,7 @@ public:
                             aircraft.phase = AT_GATE;
                             aircraft.currentSpeed = 0;
                             aircraft.lastPhaseChange = now;
-                            logEvent("[PHASE] " + aircraft.id + " (RWY-C) reached GATE.");
+                            logPhase(aircraft, " reached GATE.", &runway);
                             runway.isOccupied = false;
                             runway.currentAircraft = nullptr;
                             runway.cv.notify_one();
@@ -398,7 +1268,7 @@ public:
                             aircraft.phase = TAXI;
                             aircraft.currentSpeed = 15 + (rand() % 16);
                             aircraft.lastPhaseChange = now;
-                            logEvent("[PHASE] " + aircraft.id + " (RWY-C) departed GATE to TAXI.");
+                            logPhase(aircraft, " departed GATE to TAXI.", &runway);
                         }
                         break;
                     case TAKEOFF_ROLL:
@@ -407,7 +1277,7 @@ public:
                             aircraft.phase = CLIMB;
                             aircraft.currentSpeed = 250 + (rand() % 214);
                             aircraft.lastPhaseChange = now;
-                            logEvent("[PHASE] " + aircraft.id + " (RWY-C) moved to CLIMB.");
+                            logPhase(aircraft, " moved to CLIMB.", &runway);
                             runway.isOccupied = false;
                             runway.currentAircraft = nullptr;
                             runway.cv.notify_one();
@@ -418,7 +1288,7 @@ public:
                             aircraft.phase = CRUISE;
                             aircraft.currentSpeed = 800 + (rand() % 101);
                             aircraft.lastPhaseChange = now;
-                            logEvent("[PHASE] " + aircraft.id + " (RWY-C) reached CRUISE.");
+                            logPhase(aircraft, " reached CRUISE.", &runway);
                         }
                         break;
                     default:
@@ -435,7 +1305,7 @@ public:
                         aircraft.phase = TAXI;
                         aircraft.currentSpeed = 15 + (rand() % 16);
                         aircraft.lastPhaseChange = now;
-                        logEvent("[PHASE] " + aircraft.id + " moved to TAXI.");
+                        logPhase(aircraft, " moved to TAXI.");
                     }
                     break;
                 case TAXI:
@@ -443,7 +1313,7 @@ public:
                         aircraft.phase = AT_GATE;
                         aircraft.currentSpeed = 0;
                         aircraft.lastPhaseChange = now;
-                        logEvent("[PHASE] " + aircraft.id + " reached GATE.");
+                        logPhase(aircraft, " reached GATE.");
                         runway.isOccupied = false;
                         runway.currentAircraft = nullptr;
                         runway.cv.notify_one();
@@ -461,7 +1331,7 @@ public:
                         aircraft.phase = TAXI;
                         aircraft.currentSpeed = 15 + (rand() % 16);
                         aircraft.lastPhaseChange = now;
-                        logEvent("[PHASE] " + aircraft.id + " moved to TAXI.");
+                        logPhase(aircraft, " moved to TAXI.");
                     }
                     break;
                 case TAXI:
@@ -469,7 +1339,7 @@ public:
                         aircraft.phase = TAKEOFF_ROLL;
                         aircraft.currentSpeed = 0;
                         aircraft.lastPhaseChange = now;
-                        logEvent("[PHASE] " + aircraft.id + " moved to TAKEOFF.");
+                        logPhase(aircraft, " moved to TAKEOFF.");
                     }
                     break;
                 case TAKEOFF_ROLL:
@@ -478,7 +1348,7 @@ public:
                         aircraft.phase = CLIMB;
                         aircraft.currentSpeed = 250 + (rand() % 214);
                         aircraft.lastPhaseChange = now;
-                        logEvent("[PHASE] " + aircraft.id + " moved to CLIMB.");
+                        logPhase(aircraft, " moved to CLIMB.");
                         runway.isOccupied = false;
                         runway.currentAircraft = nullptr;
                         runway.cv.notify_one();
@@ -489,7 +1359,7 @@ public:
                         aircraft.phase = CRUISE;
                         aircraft.currentSpeed = 800 + (rand() % 101);
                         aircraft.lastPhaseChange = now;
-                        logEvent("[PHASE] " + aircraft.id + " reached CRUISE.");
+                        logPhase(aircraft, " reached CRUISE.");
                     }
                     break;
                 default:
@@ -499,11 +1369,21 @@ public:
 
     }
 
-    void radarMonitor(Aircraft& aircraft) {
+    void radarMonitor(Aircraft& aircraft, size_t slot) {
+        char avnLine[AVN_LINE_MAX];
         while (simulationRunning) {
+            size_t avnLength;
             {
                 lock_guard<mutex> lock(displayMutex);
-                monitorSpeed(aircraft);
+                if (aircraft.retired) break; // nothing left to watch
+                avnLength = monitorSpeed(aircraft, avnLine);
+
+                // holding/approach speed wanders every second; the tick loop only visits
+                // an aircraft when its phase timer fires, so the radar does this part
+                if (!aircraft.hasFault && aircraft.assignedRunway != NO_RUNWAY) {
+                    if (aircraft.phase == HOLDING) aircraft.currentSpeed = 400 + (rand() % 201); // 400-600 km/h
+                    else if (aircraft.phase == APPROACH) aircraft.currentSpeed = 240 + (rand() % 51); // 240-290 km/h
+                }
                 
                 
                 // Fuel consumption for arriving flights in DEPARTURE : TAKEOFF, CLIMBING, CRUISING
@@ -535,12 +1415,14 @@ public:
                         aircraft.priority = 5;
                         aircraft.hadLowFuel = true;
                         aircraft.mappedSimSecond = simulationTime; //new: prioritize immediately by setting time to now
+                        events.record(EV_FUEL, aircraft.id, aircraft.assignedRunway, aircraft.phase, static_cast<int32_t>(aircraft.fuelPercentage));
+                        phaseTimers.schedule(&aircraft, simulationTime + 1); // emergencies take the arrival path
 
                         //new: if emergency detected an lock not acquired i.e. not already on runway, then move
                         // Check if the aircraft is already on a runway
                         bool isOnRunway = false; //check if this flight is already on the runway
-                        string currentRunway = aircraft.getRunwayString();
-                        if (aircraft.assignedRunway != static_cast<RunwayID>(-1)) 
+                        string_view currentRunway = aircraft.getRunwayString();
+                        if (aircraft.assignedRunway != NO_RUNWAY) 
                         {
                             Runway& runway = runways[aircraft.assignedRunway];
                             unique_lock<mutex> runwayLock(runway.mtx, try_to_lock);
@@ -550,49 +1432,35 @@ public:
                             }
                         }
 
-                        // Move to cargoEmergencyQueue if not already there
+                        // Move to an emergency runway queue if not already on one
                         if (!isOnRunway) //new: move if lock not acquired
                         {
                             bool moved = false;
-                            if (aircraft.direction == NORTH || aircraft.direction == SOUTH) {
-                                lock_guard<mutex> lock(arrivalQueueMutex);
-                                priority_queue<Aircraft*, vector<Aircraft*>, AircraftComparator> temp;
-                                while (!arrivalQueue.empty()) {
-                                    Aircraft* a = arrivalQueue.top();
-                                    arrivalQueue.pop();
-                                    if (a != &aircraft) temp.push(a);
-                                    else moved = true;
-                                }
-                                arrivalQueue = temp;
-                            } else if (aircraft.direction == EAST || aircraft.direction == WEST) {
-                                lock_guard<mutex> lock(departureQueueMutex);
-                                priority_queue<Aircraft*, vector<Aircraft*>, AircraftComparator> temp;
-                                while (!departureQueue.empty()) {
-                                    Aircraft* a = departureQueue.top();
-                                    departureQueue.pop();
-                                    if (a != &aircraft) temp.push(a);
-                                    else moved = true;
-                                }
-                                departureQueue = temp;
+                            RunwayID queued = aircraft.queuedRunway;
+                            if (queued != NO_RUNWAY && !runways[queued].config.allows(EMERGENCY, aircraft.direction)) {
+                                moved = removeFromQueue(aircraft);
                             }
                         
                             if (moved) { //changed runways
-                                lock_guard<mutex> lock(cargoQueueMutex);
-                                cargoEmergencyQueue.push(&aircraft);
-                                aircraft.assignedRunway = RWY_C; //new: update runway
+                                RunwayID target = routeFor(EMERGENCY, aircraft.direction);
+                                enqueueAircraft(aircraft, target);
+                                aircraft.assignedRunway = target; //new: update runway
+                                currentRunway = aircraft.getRunwayString();
                             }
                             else //did not change runway despite being low fuel bc it was already on its own runwau
                             {
                                 //log that the aircraft remains on its current runway
-                                string msg = "[FUEL] Low fuel emergency for " + aircraft.id +
-                                             ". Set as EMERGENCY, remains on " + currentRunway + ".";
+                                LogLine msg;
+                                msg << "[FUEL] Low fuel emergency for " << aircraft.id <<
+                                       ". Set as EMERGENCY, remains on " << currentRunway << ".";
                                 logEvent(msg);
                             }
 
                     }
 
-                        string msg = "[FUEL] Low fuel emergency for " + aircraft.id +
-                                     ". Set as EMERGENCY, moved to RWY-C queue.";
+                        LogLine msg;
+                        msg << "[FUEL] Low fuel emergency for " << aircraft.id <<
+                               ". Set as EMERGENCY, moved to " << currentRunway << " queue.";
                         logEvent(msg);
                     }
                 }
@@ -613,76 +1481,48 @@ public:
                         aircraft.phase = AT_GATE;
                         aircraft.currentSpeed = 0;
                         aircraft.lastPhaseChange = time(nullptr);
-                        string msg = "[FAULT] Ground fault detected in " + aircraft.id + ". Aircraft towed to GATE.";
+                        LogLine msg;
+                        msg << "[FAULT] Ground fault detected in " << aircraft.id << ". Aircraft towed to GATE.";
                         //aircraft.isFlight = false;
                         logEvent(msg);
+                        events.record(EV_FAULT, aircraft.id, aircraft.assignedRunway, aircraft.phase, 0);
+                        updateTerminalState(aircraft);
                         
 
                         // Remove from queue
-                        if (aircraft.type == CARGO || aircraft.type == EMERGENCY) {
-                            lock_guard<mutex> lock(cargoQueueMutex);
-                            priority_queue<Aircraft*, vector<Aircraft*>, AircraftComparator> temp;
-                            while (!cargoEmergencyQueue.empty()) {
-                                Aircraft* a = cargoEmergencyQueue.top();
-                                cargoEmergencyQueue.pop();
-                                if (a != &aircraft) temp.push(a);
-                            }
-                            cargoEmergencyQueue = temp;
-                        } else if (aircraft.direction == NORTH || aircraft.direction == SOUTH) {
-                            lock_guard<mutex> lock(arrivalQueueMutex);
-                            priority_queue<Aircraft*, vector<Aircraft*>, AircraftComparator> temp;
-                            while (!arrivalQueue.empty()) {
-                                Aircraft* a = arrivalQueue.top();
-                                arrivalQueue.pop();
-                                if (a != &aircraft) temp.push(a);
-                            }
-                            arrivalQueue = temp;
-                        } else {
-                            lock_guard<mutex> lock(departureQueueMutex);
-                            priority_queue<Aircraft*, vector<Aircraft*>, AircraftComparator> temp;
-                            while (!departureQueue.empty()) {
-                                Aircraft* a = departureQueue.top();
-                                departureQueue.pop();
-                                if (a != &aircraft) temp.push(a);
-                            }
-                            departureQueue = temp;
-                        }
+                        removeFromQueue(aircraft);
                     }
                 }
             }
-            this_thread::sleep_for(chrono::seconds(1));
+            // queued for the emitter's writer thread outside displayMutex: with --avn-overflow
+            // block a full ring stalls this radar thread only, not the tick loop and the views
+            if (avnLength > 0) avnEmitter.emit(string_view(avnLine, avnLength));
+
+            // next look in a second, sooner if the flight is retired or the run ends
+            unique_lock<mutex> lock(displayMutex);
+            radarWake.wait_for(lock, chrono::seconds(1), [&]() { return aircraft.retired || !simulationRunning; });
         }
+        // the slot may be reused as soon as the tick loop sees this, aircraft is not touched again
+        lock_guard<mutex> lock(radarExitMutex);
+        exitedSlots.push_back(slot);
     }
 
     void runwayController(Runway& runway) {
-        priority_queue<Aircraft*, vector<Aircraft*>, AircraftComparator>* assignedQueue = nullptr;
-        mutex* queueMutex = nullptr;
-
-        // Determine queue
-        if (runway.id == RWY_A) {
-            assignedQueue = &arrivalQueue;
-            queueMutex = &arrivalQueueMutex;
-        } else if (runway.id == RWY_B) {
-            assignedQueue = &departureQueue;
-            queueMutex = &departureQueueMutex;
-        } else {
-            assignedQueue = &cargoEmergencyQueue;
-            queueMutex = &cargoQueueMutex;
-        }
-
         while (simulationRunning) {
             Aircraft* nextAircraft = nullptr;
 
             // Check for aircraft in queue
             {
-                lock_guard<mutex> lock(*queueMutex);
-                if (!assignedQueue->empty()) 
+                lock_guard<mutex> lock(runway.queueMutex);
+                if (!runway.queue.empty()) 
                 {
-                    nextAircraft = assignedQueue->top();
-                    //new check time OR emergency to prioritize
-                    if (runway.id == RWY_C || nextAircraft->mappedSimSecond <= simulationTime) 
+                    nextAircraft = runway.queue.top();
+                    //new check time OR immediate runway (emergencies) to prioritize
+                    if (runway.config.policy == IMMEDIATE || nextAircraft->mappedSimSecond <= simulationTime) 
                     {
-                        assignedQueue->pop();
+                        runway.queue.pop();
+                        runway.claimed = nextAircraft; // before it leaves the queue, so it is never unowned
+                        nextAircraft->queuedRunway = NO_RUNWAY;
                     } 
                     else 
                     {
@@ -696,6 +1536,10 @@ public:
                 // Wait for runway to be available
                 unique_lock<mutex> runwayLock(runway.mtx);
                 runway.cv.wait(runwayLock, [&](){ return !runway.isOccupied; });
+                if (nextAircraft->hasFault) { // faulted and towed while it waited for the runway
+                    runway.claimed = nullptr;
+                    continue;
+                }
 
                 // Calculate waiting time
                 time_t now = time(nullptr);
@@ -704,12 +1548,17 @@ public:
                 // Assign aircraft to runway
                 runway.isOccupied = true;
                 runway.currentAircraft = nextAircraft;
+                runway.claimed = nullptr;
                 nextAircraft->assignedRunway = runway.id;
+                phaseTimers.schedule(nextAircraft, simulationTime + 1); // its phases can move now
 
-                string msg = "[RUNWAY] " + nextAircraft->id + " assigned to " + runway.getName() +
-                             " (Waited: " + to_string(nextAircraft->waitTime) + "s, Fuel: " +
-                             to_string(nextAircraft->fuelPercentage) + "%)";
+                LogLine msg;
+                msg << "[RUNWAY] " << nextAircraft->id << " assigned to " << runway.getName() <<
+                       " (Waited: " << to_string(nextAircraft->waitTime) << "s, Fuel: " <<
+                       to_string(nextAircraft->fuelPercentage) << "%)";
                 logEvent(msg);
+                events.record(EV_WAIT, nextAircraft->id, runway.id, nextAircraft->phase, static_cast<int32_t>(nextAircraft->waitTime));
+                events.record(EV_DISPATCH, nextAircraft->id, runway.id, nextAircraft->phase, static_cast<int32_t>(nextAircraft->fuelPercentage));
 
                 // Simulate runway operation
                 this_thread::sleep_for(chrono::seconds(5));
@@ -728,60 +1577,157 @@ public:
 
                 runway.cv.notify_one();
 
-                msg = "[RUNWAY] " + nextAircraft->id + " completed operation on " + runway.getName();
+                msg.clear() << "[RUNWAY] " << nextAircraft->id << " completed operation on " << runway.getName();
                 logEvent(msg);
+                events.record(EV_RELEASE, nextAircraft->id, runway.id, nextAircraft->phase, 0);
+            } else if (nextAircraft) {
+                runway.claimed = nullptr; // faulted before it was popped, never dispatched
             }
 
             this_thread::sleep_for(chrono::milliseconds(100)); // Prevent busy waiting
         }
     }
 
+    // One flight row of the console status, copied out under displayMutex. The views
+    // point at interned or static strings, so the row can be formatted after unlocking.
+    struct StatusRow {
+        string_view id, type, phase, runway;
+        double speed, wait, fuel;
+        int priority, avn;
+    };
+
+    // Console status. Each second the rows on the current page are copied from
+    // activeFlights under displayMutex, the frame is formatted after the lock is released, and only the
+    // characters that changed since the last frame are rewritten (see term_view.h).
+    // Log lines scroll in the rows under the view. A fleet larger than one screen is
+    // paged, a page every STATUS_PAGE_SECONDS. When stdout is not a terminal a single
+    // status line is printed every STATUS_PLAIN_SECONDS instead.
     void displayStatus() {
-        while (simulationRunning) {
-            system("clear"); // Clear the screen
-
-            lock_guard<mutex> lock(displayMutex);
+        const bool terminal = isatty(STDOUT_FILENO);
+        TerminalView view;
+        int terminalRows = 0, terminalCols = 0;
+        vector<StatusRow> rows;
+        struct RunwayRow { string_view flight, phase; };
+        vector<RunwayRow> runwayRows(runways.size());
+        size_t page = 0, active = 0;
+        int shownFor = 0, time = 0, plainAt = -STATUS_PLAIN_SECONDS;
+        long retired = 0;
+        char line[512];
+        bool drawn = false;
 
-            cout << "=== AirControlX Status ===" << endl;
-            cout << "Simulation Time: " << simulationTime << "/" << SIMULATION_DURATION << " seconds" << endl << endl;
+        while (simulationRunning) {
+            // the terminal size decides how many flights fit on a page
+            int newRows = 24, newCols = 100;
+            winsize size{};
+            if (terminal && ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0 && size.ws_col > 0) {
+                newRows = size.ws_row;
+                newCols = size.ws_col;
+            }
+            const int fixedLines = 8 + static_cast<int>(runways.size()); //titles, runway rows, column header
+            if (newRows != terminalRows || newCols != terminalCols) {
+                terminalRows = newRows;
+                terminalCols = newCols;
+                view.resize(newRows, newCols, max(fixedLines + 1, newRows - max(5, newRows / 4))); //a quarter is left for the log
+            }
+            const size_t perPage = max(1, view.view_height() - fixedLines);
+            if (page * perPage >= active) page = 0; //flights retired, the page is gone
 
-            // Display runways
-            cout << "=== Runways ===" << endl;
-            for (auto& runway : runways) {
-                cout << runway.getName() << ": ";
-                if (runway.isOccupied && runway.currentAircraft) {
-                    cout << runway.currentAircraft->id << " (" << runway.currentAircraft->getPhaseString() << ")";
-                } else {
-                    cout << "Available";
-                }
-                cout << endl;
-            }
-            cout << endl;
-
-            // Display flights
-            cout << "=== Active Flights ===" << endl;
-            cout << left << setw(10) << "Flight ID" << setw(12) << "Type"
-                 << setw(10) << "Phase" << setw(10) << "Speed"
-                 << setw(10) << "Priority" << setw(10) << "Runway"
-                 << setw(5) << "AVN" << setw(8) << "Wait(s)"
-                 << setw(10) << "Fuel(%)" << endl;
-            cout << string(80, '-') << endl;
-  
-            for (auto& flight : flights) //format the output
+            // snapshot: only the rows on this page are copied, the rest are counted
+            rows.clear();
             {
-                cout << left << setw(10) << flight.id
-                     << setw(12) << flight.getTypeString()             
-                     << setw(12) << (flight.hasFault ? "TOWED" : flight.getPhaseString()) //show towed in output
-                     << setw(10) << fixed << setprecision(2) << flight.currentSpeed
-                     << setw(10) << flight.priority
-                     << setw(10) << flight.getRunwayString()
-                     << setw(5) << flight.AVNcount //old: (flight.hasAVN ? "Yes" : "No")
-                     << setw(8) << fixed << setprecision(2) << flight.waitTime
-                     << setw(10) << fixed << setprecision(2) << flight.fuelPercentage << endl;
+                lock_guard<mutex> lock(displayMutex);
+                time = simulationTime;
+                for (size_t i = 0; i < runways.size(); i++) {
+                    const Aircraft* current = runways[i].isOccupied ? runways[i].currentAircraft : nullptr;
+                    runwayRows[i] = current ? RunwayRow{current->id, current->getPhaseString()} : RunwayRow{};
+                }
+                active = activeFlights.size();
+                for (size_t i = page * perPage; i < active && rows.size() < perPage; i++) {
+                    const Aircraft& flight = *activeFlights[i];
+                    rows.push_back({flight.id, flight.getTypeString(),
+                                    flight.hasFault ? string_view("TOWED") : flight.getPhaseString(), //show towed in output
+                                    flight.getRunwayString(), flight.currentSpeed, flight.waitTime,
+                                    flight.fuelPercentage, flight.priority, flight.AVNcount});
+                }
+                retired = history.size();
+            }
+            const size_t pages = max<size_t>(1, (active + perPage - 1) / perPage);
+
+            if (!terminal) {
+                if (time >= plainAt + STATUS_PLAIN_SECONDS) {
+                    plainAt = time;
+                    LogLine status;
+                    status << "[ATC] Status at " << long(time) << " s: " << long(active) << " active, " << retired << " retired";
+                    for (size_t i = 0; i < runways.size(); i++)
+                        status << ", " << runways[i].config.name << " " << (runwayRows[i].flight.empty() ? "free" : runwayRows[i].flight);
+                    status << ", AVN generator " << (avnGenerator.up() ? "up" : "down") << " ("
+                           << avnGenerator.restart_count() << " restarts)";
+                    cout << string_view(status) << endl;
+                }
+                this_thread::sleep_for(chrono::seconds(1));
+                continue;
             }
 
+            // build the frame, formatted from the snapshot with no lock held
+            int row = 0;
+            snprintf(line, sizeof(line), "=== AirControlX Status ===   Simulation Time: %d/%d seconds", time, SIMULATION_DURATION);
+            view.set_line(row++, line);
+            if (avnGenerator.up())
+                snprintf(line, sizeof(line), "AVN generator: up %lds, %ld restarts", avnGenerator.uptime_seconds(),
+                         avnGenerator.restart_count());
+            else
+                snprintf(line, sizeof(line), "AVN generator: DOWN, restarting (%ld restarts)", avnGenerator.restart_count());
+            view.set_line(row++, line);
+            view.set_line(row++, "=== Runways ===");
+            for (size_t i = 0; i < runways.size(); i++) {
+                const RunwayRow& runway = runwayRows[i];
+                if (runway.flight.empty())
+                    snprintf(line, sizeof(line), "%s: Available", runways[i].getName().c_str());
+                else
+                    snprintf(line, sizeof(line), "%s: %.*s (%.*s)", runways[i].getName().c_str(), int(runway.flight.size()),
+                             runway.flight.data(), int(runway.phase.size()), runway.phase.data());
+                view.set_line(row++, line);
+            }
+            view.set_line(row++, "");
+            if (pages > 1)
+                snprintf(line, sizeof(line), "=== Active Flights === (%ld retired)   page %zu/%zu, flights %zu-%zu of %zu",
+                         retired, page + 1, pages, page * perPage + 1, page * perPage + rows.size(), active);
+            else
+                snprintf(line, sizeof(line), "=== Active Flights === (%ld retired)", retired);
+            view.set_line(row++, line);
+            snprintf(line, sizeof(line), "%-10s%-12s%-12s%-10s%-10s%-10s%-5s%-8s%-10s",
+                     "Flight ID", "Type", "Phase", "Speed", "Priority", "Runway", "AVN", "Wait(s)", "Fuel(%)");
+            view.set_line(row++, line);
+            view.set_line(row++, string(80, '-'));
+            for (const StatusRow& flight : rows) {
+                snprintf(line, sizeof(line), "%-10.*s%-12.*s%-12.*s%-10.2f%-10d%-10.*s%-5d%-8.2f%-10.2f",
+                         int(flight.id.size()), flight.id.data(), int(flight.type.size()), flight.type.data(),
+                         int(flight.phase.size()), flight.phase.data(), flight.speed, flight.priority,
+                         int(flight.runway.size()), flight.runway.data(), flight.avn, flight.wait, flight.fuel);
+                view.set_line(row++, line);
+            }
+            while (row < view.view_height()) view.set_line(row++, "");
+
+            // log lines are written under logMutex too, so the two never interleave
+            const string& bytes = view.diff();
+            if (!bytes.empty()) {
+                lock_guard<mutex> lock(logMutex);
+                cout.flush();
+                write_all(STDOUT_FILENO, bytes);
+                drawn = true;
+            }
+
+            if (++shownFor >= STATUS_PAGE_SECONDS) {
+                shownFor = 0;
+                page = (page + 1) % pages;
+            }
             this_thread::sleep_for(chrono::seconds(1));
         }
+
+        if (drawn) {
+            lock_guard<mutex> lock(logMutex);
+            write_all(STDOUT_FILENO, view.release());
+        }
     }
 
     void inputFlights() 
@@ -803,18 +1749,21 @@ public:
 
         for (int i = 0; i < n; i++) {
             Aircraft ac;
+            string entry;
             cout << "\nFlight " << i+1 << ":" << endl;
 
             cout << "Flight ID: ";
-            getline(cin, ac.id);
-            if (ac.id.empty()) {
+            getline(cin, entry);
+            if (entry.empty()) {
                 cout << "Flight ID cannot be empty. Try again." << endl;
                 i--;
                 continue;
             }
+            ac.id = names.intern(entry);
 
             cout << "Airline Name: ";
-            getline(cin, ac.airline);
+            getline(cin, entry);
+            ac.airline = names.intern(entry);
 
             int typeInput;
             do {
@@ -864,11 +1813,12 @@ public:
             bool validTime = false;
             while (!validTime) {
                 cout << "Scheduled Time (hh:mm): ";
-                getline(cin, ac.scheduledTimeStr);
+                getline(cin, entry);
 
                 int hh, mm;
-                if (sscanf(ac.scheduledTimeStr.c_str(), "%d:%d", &hh, &mm) == 2) {
+                if (sscanf(entry.c_str(), "%d:%d", &hh, &mm) == 2) {
                     if (hh >= 0 && hh < 24 && mm >= 0 && mm < 60) {
+                        ac.scheduledTimeStr = names.intern(entry);
                         ac.scheduledMinutes = hh * 60 + mm;
                         validTime = true;
                     } else {
@@ -879,27 +1829,20 @@ public:
                 }
             }
 
-            ac.phase = (ac.direction == NORTH || ac.direction == SOUTH) ? HOLDING : AT_GATE;
-            ac.currentSpeed = (ac.phase == HOLDING) ? 400 + (rand() % 201) : 0;
-            ac.isEmergency = (ac.type == EMERGENCY);
-            ac.hasAVN = false;
-            ac.hasFault = false;
-            ac.lastPhaseChange = time(nullptr);
-            ac.queueEntryTime = time(nullptr);
-            ac.fuelPercentage = (ac.direction == NORTH || ac.direction == SOUTH) ? (70 + (rand() % 31)) : 100.0;  // b/w 70-100 for arrivals, 100 for departures
-            ac.hadLowFuel = false;
+            unsigned seed = rand();
+            initFlightDefaults(ac, time(nullptr), seed);
 
-            flights.push_back(ac);
+            plan.push_back(ac);
         }
     }
 
     void mapScheduledTimes() {
-        if (flights.empty()) return;
+        if (plan.empty()) return;
 
-        int minMinutes = flights[0].scheduledMinutes;
-        int maxMinutes = flights[0].scheduledMinutes;
+        int minMinutes = plan[0].scheduledMinutes;
+        int maxMinutes = plan[0].scheduledMinutes;
 
-        for (auto& flight : flights) {
+        for (auto& flight : plan) {
             if (flight.scheduledMinutes < minMinutes) minMinutes = flight.scheduledMinutes;
             if (flight.scheduledMinutes > maxMinutes) maxMinutes = flight.scheduledMinutes;
         }
@@ -907,7 +1850,7 @@ public:
         int realTimeWindow = maxMinutes - minMinutes;
         if (realTimeWindow == 0) realTimeWindow = 1;
 
-        for (auto& flight : flights) {
+        for (auto& flight : plan) {
             int relativeMinute = flight.scheduledMinutes - minMinutes;
             double ratio = static_cast<double>(relativeMinute) / realTimeWindow;
             flight.mappedSimSecond = static_cast<int>(ratio * SIMULATION_DURATION);
@@ -953,41 +1896,45 @@ public:
     
 
 
+    // Sort and route the plan, then admit the flights due in the first ADMIT_LEAD_SECONDS
+    // (and every flight for an immediate runway); the tick loop admits the rest as their time comes
     void scheduleFlights() {
+        auto started = chrono::steady_clock::now();
+
         // Sort flights by scheduled time and priority
-        sort(flights.begin(), flights.end(), [](const Aircraft& a, const Aircraft& b) {
+        parallelSort(plan, [](const Aircraft& a, const Aircraft& b) {
             if (a.mappedSimSecond != b.mappedSimSecond) {
                 return a.mappedSimSecond < b.mappedSimSecond;
             }
             return a.priority > b.priority;
         });
-
-        // Assign to queues
-        for (auto& flight : flights) {
-            flight.queueEntryTime = time(nullptr); // Record queue entry time
-            if (flight.type == CARGO || flight.type == EMERGENCY || flight.isEmergency) {
-                lock_guard<mutex> lock(cargoQueueMutex);
-                cargoEmergencyQueue.push(&flight);
-            } else if (flight.direction == NORTH || flight.direction == SOUTH) {
-                lock_guard<mutex> lock(arrivalQueueMutex);
-                arrivalQueue.push(&flight);
-            } else {
-                lock_guard<mutex> lock(departureQueueMutex);
-                departureQueue.push(&flight);
-            }
+        for (auto& flight : plan) {
+            AircraftType routeType = flight.isEmergency ? EMERGENCY : flight.type;
+            flight.queuedRunway = routeFor(routeType, flight.direction); // queued there on admission
         }
+        // flights for immediate runways go first, so admission still takes the plan in order
+        stable_partition(plan.begin(), plan.end(), [&](const Aircraft& flight) {
+            return runways[flight.queuedRunway].config.policy == IMMEDIATE;
+        });
+        admitFlights(ADMIT_LEAD_SECONDS);
+
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+        cout << "[ATC] Scheduled " << plan.size() << " flights on " << runways.size() << " runways in "
+             << fixed << setprecision(2) << ms << " ms (" << activeFlights.size() << " admitted, the rest join "
+             << ADMIT_LEAD_SECONDS << " s before their slot)" << endl;
     }
 
     void summarizeSimulation() {
         lock_guard<mutex> lock(displayMutex);
-        cout << "\n=== Simulation Summary ===" << endl;
-        cout << "Total Flights: " << flights.size() << endl;
 
         int totalAVNs = 0, totalFaults = 0, totalLowFuel = 0;
         double totalWaitTime = 0.0;
         int processedFlights = 0;
+        size_t totalFlights = history.size();
 
-        for (const auto& flight : flights) {
+        for (const Aircraft* active : activeFlights) { // retired ones are counted from history below
+            const Aircraft& flight = *active;
+            totalFlights++;
             if (flight.hasAVN) totalAVNs++;
             if (flight.hasFault) totalFaults++;
             if (flight.hadLowFuel) totalLowFuel++;
@@ -996,6 +1943,18 @@ public:
                 processedFlights++;
             }
         }
+        for (const auto& record : history) {
+            if (record.AVNcount > 0) totalAVNs++;
+            if (record.hadFault) totalFaults++;
+            if (record.hadLowFuel) totalLowFuel++;
+            if (record.waitTime > 0.0) {
+                totalWaitTime += record.waitTime;
+                processedFlights++;
+            }
+        }
+
+        cout << "\n=== Simulation Summary ===" << endl;
+        cout << "Total Flights: " << totalFlights << " (" << history.size() << " retired during the run)" << endl;
 
         double avgWaitTime = processedFlights > 0 ? totalWaitTime / processedFlights : 0.0;
         cout << "Total AVNs Issued: " << TotalAVNs << endl;
@@ -1004,7 +1963,7 @@ public:
         cout << "Average Waiting Time: " << fixed << setprecision(2) << avgWaitTime << " seconds" << endl;
         cout << "==========================" << endl;
 
-        string msg = "[SUMMARY] Flights: " + to_string(flights.size()) +
+        string msg = "[SUMMARY] Flights: " + to_string(totalFlights) +
                      ", AVNs: " + to_string(TotalAVNs) +
                      ", Faults: " + to_string(totalFaults) +
                      ", Low Fuel: " + to_string(totalLowFuel) +
@@ -1021,53 +1980,184 @@ public:
             runwayThreads.emplace_back(&AirControlX::runwayController, this, ref(runway));
         }
 
-        // Start radar monitoring threads for each flight
-        for (auto& flight : flights) {
-            flightThreads.emplace_back(&AirControlX::radarMonitor, this, ref(flight));
-        }
+        // Start radar monitoring threads for the flights admitted so far, admitFlights starts the rest
+        for (size_t slot = 0; slot < flights.size(); slot++) startRadar(slot);
 
         // Start display thread
         thread displayThread(&AirControlX::displayStatus, this);
 
-        // Simulation timer
+        // Every flight gets a first look on the tick after it is admitted, after that its
+        // timer decides. Size the tick loop's containers for the whole plan so ticks do not
+        // allocate, apart from what admitting a flight costs (its radar thread).
+        vector<Aircraft*> dueFlights;
+        dueFlights.reserve(plan.size());
+        history.reserve(plan.size());
+        joinSlots.reserve(plan.size());
+        freeSlots.reserve(plan.size());
+        retireBatch.reserve(plan.size());
+        retireLater.reserve(plan.size());
+        admittedSlots.reserve(plan.size());
+        {
+            lock_guard<mutex> lock(terminalMutex);
+            retireCandidates.reserve(plan.size());
+        }
+        {
+            lock_guard<mutex> lock(radarExitMutex);
+            exitedSlots.reserve(plan.size());
+        }
+        for (Aircraft* flight : activeFlights) {
+            phaseTimers.schedule(flight, 1);
+            updateTerminalState(*flight);
+        }
+        const int totalFlights = static_cast<int>(plan.size());
+
+        // span names for the slow tick trace, by the phase a handler started in
+        static const char* phaseSpanNames[CRUISE + 1] = {
+            "phase Holding", "phase Approach", "phase Landing", "phase Taxiing",
+            "phase At Gate", "phase Takeoff", "phase Climbing", "phase Cruising"};
+        tickThread = this_thread::get_id();
+        if (!tickTrace.open(SLOW_TICK_FILE)) {
+            cerr << "[ATC] Failed to open " << SLOW_TICK_FILE << ", slow ticks are not traced" << endl;
+        }
+        const auto simStartTime = chrono::steady_clock::now();
+        const int64_t simStart = chrono::duration_cast<chrono::microseconds>(simStartTime.time_since_epoch()).count();
+
+        // Simulation timer: tick N is due N seconds after the start, so time spent
+        // working in one tick does not push back every tick after it
         while (simulationTime < SIMULATION_DURATION) {
-            this_thread::sleep_for(chrono::seconds(1));
+            this_thread::sleep_until(simStartTime + chrono::seconds(simulationTime + 1));
             simulationTime++;
 
-            // Update flight phases
-            for (auto& flight : flights) {
-                updateFlightPhase(flight);
+            // drift = how late this tick woke up against its slot on the 1 s clock
+            int64_t tickStart = trace_now_us();
+            int64_t drift = tickStart - simStart - int64_t(simulationTime) * 1000000;
+            tickTrace.begin(simulationTime, tickStart);
+            unsigned long allocationsBefore = threadAllocations;
+
+            // Update flight phases, only for aircraft whose timer fired
+            dueFlights.clear();
+            phaseTimers.advance(simulationTime, dueFlights);
+            int64_t spanStart = trace_now_us();
+            tickTrace.span("timers", tickStart, spanStart - tickStart);
+            for (Aircraft* flight : dueFlights) {
+                FlightPhase before = flight->phase;
+                updateFlightPhase(*flight);
+                schedulePhaseCheck(*flight);
+                int64_t spanEnd = trace_now_us();
+                phaseCost[before].add(spanEnd - spanStart);
+                tickTrace.span(phaseSpanNames[before], spanStart, spanEnd - spanStart, flight->id);
+                spanStart = spanEnd;
+            }
+            phaseChecks += dueFlights.size();
+
+            retireFlights();
+            int64_t retired = trace_now_us();
+            tickTrace.span("retire", spanStart, retired - spanStart);
+
+            // planned flights join now, in the slots retirement just freed where it can
+            admitFlights(simulationTime + ADMIT_LEAD_SECONDS);
+            int64_t tickEnd = trace_now_us();
+            tickTrace.span("admit", retired, tickEnd - retired);
+
+            unsigned long allocated = threadAllocations - allocationsBefore;
+            if (allocated) {
+                tickAllocations += allocated;
+                ticksAllocating++;
+                lastAllocatingTick = simulationTime;
             }
+
+            int64_t work = tickEnd - tickStart;
+            tickWork.add(work);
+            tickDrift.add(drift);
+            tickTrace.end(work, drift, work > TICK_BUDGET_US);
             
-          //exit early if all aircraft are either cruising or towed or at gate (depts)
-          bool allDone = all_of(flights.begin(), flights.end(), [](const Aircraft& ac)
-          { return ac.phase == CRUISE |ac.hasFault | (ac.phase==AT_GATE&&!ac.hasFault && (ac.direction == NORTH || ac.direction == SOUTH)); } //new end condition
-          );
-          if (allDone) 
+          //exit early if all aircraft are either cruising or towed or at gate (arrivals)
+          if (terminalFlights.load() == totalFlights) 
           {
               simulationComplete = true;
+              viewVersion++;
               break; //exit early
 
           }
+          viewVersion++; //the GUI redraws once per tick, not once per spin
             
         }
 
         // Clean up
-        simulationRunning = false;
+        {
+            lock_guard<mutex> lock(displayMutex);
+            simulationRunning = false;
+        }
+        radarWake.notify_all();
 
         for (auto& thread : runwayThreads) {
             if (thread.joinable()) thread.join();
         }
 
-        for (auto& thread : flightThreads) {
+        for (auto& thread : flightThreads) { // flights still active at the end, retired ones were joined already
             if (thread.joinable()) thread.join();
         }
 
         if (displayThread.joinable()) displayThread.join();
 
+        closeAvnPipe();
         summarizeSimulation();
+        cout << "[ATC] Phase timers fired " << phaseChecks << " times over " << simulationTime << " ticks for "
+             << plan.size() << " flights in " << flights.size() << " slots" << endl;
+        tickTrace.close();
+        reportTickTiming();
         cout << "\nSimulation Complete!" << endl;
     }
+
+    // Let the emitter deliver what is still queued, let the generator finish, then
+    // report how the AVN pipe kept up
+    void closeAvnPipe() {
+        avnEmitter.close();
+        avnGenerator.stop();
+        AvnEmitterStats stats = avnEmitter.snapshot();
+        const LatencyHistogram& latency = avnEmitter.latency();
+        cout << "[ATC] AVN pipe (" << avn_policy_name(avnEmitter.overflow_policy()) << "): " << stats.emitted
+             << " queued, " << stats.sent << " acknowledged, " << stats.resent << " resent, " << stats.dropped
+             << " dropped, " << stats.spilled << " spilled, " << stats.blocked << " blocked, max depth "
+             << stats.max_depth;
+        if (stats.write_errors > 0) cout << ", " << stats.write_errors << " write errors";
+        if (latency.count() > 0) {
+            cout << "; queue to journal p50 " << latency.percentile(50) << " us, p99 " << latency.percentile(99)
+                 << " us, max " << latency.max() << " us";
+        }
+        cout << endl;
+        cout << "[ATC] AVN generator: up " << avnGenerator.total_up_seconds() << " s, "
+             << avnGenerator.restart_count() << " restarts" << endl;
+    }
+
+    void reportTickTiming() {
+        cout << "\n=== Tick Timing (us) ===" << endl;
+        cout << left << setw(18) << "" << right << setw(8) << "count" << setw(10) << "p50" << setw(10) << "p90"
+             << setw(10) << "p99" << setw(10) << "max" << endl;
+        auto row = [](const string& name, const LatencyHistogram& h) {
+            if (h.count() == 0) return;
+            cout << left << setw(18) << name << right << setw(8) << h.count() << setw(10) << h.percentile(50)
+                 << setw(10) << h.percentile(90) << setw(10) << h.percentile(99) << setw(10) << h.max() << endl;
+        };
+        row("tick work", tickWork);
+        row("tick drift", tickDrift);
+        row("lock wait", lockWait);
+        for (int p = HOLDING; p <= CRUISE; p++) {
+            Aircraft phaseOnly;
+            phaseOnly.phase = static_cast<FlightPhase>(p);
+            row("phase " + string(phaseOnly.getPhaseString()), phaseCost[p]);
+        }
+        cout << "(percentiles are bucket upper bounds, within 2x)" << endl;
+        cout << "Runway lock misses: " << runwayLockMisses << ", ticks over " << TICK_BUDGET_US / 1000
+             << " ms: " << tickTrace.traced_ticks();
+        if (tickTrace.traced_ticks() > 0) cout << " (traced to " << SLOW_TICK_FILE << ")";
+        cout << endl;
+        cout << "Tick loop heap allocations: " << tickAllocations << " in " << ticksAllocating << " of "
+             << simulationTime << " ticks";
+        if (ticksAllocating > 0) cout << ", none after tick " << lastAllocatingTick;
+        cout << endl;
+        cout << "Interned strings: " << names.size() << endl;
+    }
 };
 
 //structures and variables to help with input :( -----------------------------------------------------
@@ -1389,50 +2479,488 @@ public:
          }
     }
 
-    void resetForNewFlight() //clear fields
+    void resetForNewFlight() //clear fields
+    {
+        data.id = "";
+        data.airline = "";
+        data.type = "";
+        data.direction = "";
+        data.priority = "";
+        data.scheduledTime = "";
+        data.currentField = 0;
+        data.complete = false;
+        errorText.setString("");
+    }
+};
+
+void processInputData(AirControlX& atc, const FlightInputData& data) //when u input the data for a slight, initialize aircraft
+{
+    //add one aircradft to the atc at a time
+        Aircraft ac;
+        ac.id = names.intern(data.id);
+        ac.airline = names.intern(data.airline);
+        ac.type = static_cast<AircraftType>(stoi(data.type));
+        ac.direction = static_cast<Direction>(stoi(data.direction));
+        ac.priority = stoi(data.priority);
+        ac.scheduledTimeStr = names.intern(data.scheduledTime);
+
+        //parse time
+        int hh, mm;
+        sscanf(data.scheduledTime.c_str(), "%d:%d", &hh, &mm);
+        ac.scheduledMinutes = hh * 60 + mm;
+
+        //set other defaults (module 2 wala code)
+        unsigned seed = rand();
+        initFlightDefaults(ac, time(nullptr), seed);
+
+        atc.plan.push_back(ac);
+}
+
+// ---------------- FLIGHT PLAN FILES ----------------
+// One flight per line, same fields as the input screen:
+//   FlightID,Airline,Type(0-2),Direction(0-3),Priority(1-5),hh:mm
+// Blank lines and lines starting with '#' are skipped.
+
+struct FlightPlanResult {
+    size_t lines = 0;
+    vector<size_t> badLines; // 1-based line numbers that did not parse
+    double seconds = 0.0;
+};
+
+// Hand-rolled field parsers for the mapped loader: no locale, no allocation, no exceptions
+static bool parsePlanInt(const char* p, const char* end, int minValue, int maxValue, int& out)
+{
+    if (p == end || end - p > 9) return false;
+    int value = 0;
+    for (; p < end; ++p) {
+        if (*p < '0' || *p > '9') return false;
+        value = value * 10 + (*p - '0');
+    }
+    if (value < minValue || value > maxValue) return false;
+    out = value;
+    return true;
+}
+
+static bool parsePlanClock(const char* p, const char* end, int& minutes)
+{
+    const char* colon = static_cast<const char*>(memchr(p, ':', end - p));
+    int hh, mm;
+    if (!colon || !parsePlanInt(p, colon, 0, 23, hh) || !parsePlanInt(colon + 1, end, 0, 59, mm)) return false;
+    minutes = hh * 60 + mm;
+    return true;
+}
+
+// Parse the lines in [p, end) into out. Line numbers in badLines are relative to the chunk.
+// Strings go into the chunk's own table, so the workers never wait on each other's lock.
+static void parsePlanChunk(const char* p, const char* end, vector<Aircraft>& out, FlightPlanResult& result,
+                           StringTable& chunkNames, unsigned seed)
+{
+    time_t now = time(nullptr);
+    while (p < end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+        const char* lineEnd = (eol > p && eol[-1] == '\r') ? eol - 1 : eol;
+        result.lines++;
+
+        if (lineEnd > p && *p != '#') {
+            const char* field[6];
+            const char* fieldEnd[6];
+            int count = 0;
+            const char* start = p;
+            for (const char* c = p; c <= lineEnd && count < 6; ++c) {
+                if (c == lineEnd || *c == ',') {
+                    field[count] = start;
+                    fieldEnd[count] = c;
+                    count++;
+                    start = c + 1;
+                }
+            }
+
+            Aircraft ac;
+            int type, direction, priority;
+            if (count == 6 && fieldEnd[5] == lineEnd && field[0] != fieldEnd[0] &&
+                parsePlanInt(field[2], fieldEnd[2], 0, 2, type) &&
+                parsePlanInt(field[3], fieldEnd[3], 0, 3, direction) &&
+                parsePlanInt(field[4], fieldEnd[4], 1, 5, priority) &&
+                parsePlanClock(field[5], fieldEnd[5], ac.scheduledMinutes)) {
+                ac.id = chunkNames.intern(string_view(field[0], fieldEnd[0] - field[0]));
+                ac.airline = chunkNames.intern(string_view(field[1], fieldEnd[1] - field[1]));
+                ac.type = static_cast<AircraftType>(type);
+                ac.direction = static_cast<Direction>(direction);
+                ac.priority = priority;
+                ac.scheduledTimeStr = chunkNames.intern(string_view(field[5], fieldEnd[5] - field[5]));
+                initFlightDefaults(ac, now, seed);
+                out.push_back(std::move(ac));
+            } else {
+                result.badLines.push_back(result.lines);
+            }
+        }
+        p = eol + 1;
+    }
+}
+
+// mmap the plan, cut it into one chunk per thread on line boundaries and parse the chunks in parallel
+bool loadFlightPlanMapped(const string& path, vector<Aircraft>& flights, FlightPlanResult& result, unsigned threads)
+{
+    auto started = chrono::steady_clock::now();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        return false;
+    }
+    size_t size = st.st_size;
+    if (size == 0) {
+        close(fd);
+        return true;
+    }
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return false;
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    const char* data = static_cast<const char*>(mapped);
+    const char* end = data + size;
+
+    if (threads == 0) threads = 1;
+    vector<const char*> cuts{data};
+    for (unsigned i = 1; i < threads; i++) {
+        const char* cut = data + size * i / threads;
+        if (cut <= cuts.back()) continue;
+        const char* nl = static_cast<const char*>(memchr(cut, '\n', end - cut));
+        if (!nl || nl + 1 >= end) break;
+        cuts.push_back(nl + 1);
+    }
+    cuts.push_back(end);
+
+    size_t chunks = cuts.size() - 1;
+    vector<vector<Aircraft>> parsed(chunks);
+    vector<FlightPlanResult> partial(chunks);
+    vector<StringTable> chunkNames(chunks);
+    vector<thread> workers;
+    unsigned baseSeed = rand();
+    for (size_t i = 0; i < chunks; i++) {
+        // about 40 bytes a line, so reserving up front avoids regrowing the vector
+        parsed[i].reserve((cuts[i + 1] - cuts[i]) / 32 + 1);
+        chunkNames[i].reserve((cuts[i + 1] - cuts[i]) / 32 + 1); // mostly flight ids, one per line
+        workers.emplace_back(parsePlanChunk, cuts[i], cuts[i + 1], ref(parsed[i]), ref(partial[i]),
+                             ref(chunkNames[i]), baseSeed + static_cast<unsigned>(i));
+    }
+    for (auto& worker : workers) worker.join();
+    munmap(mapped, size);
+    for (auto& table : chunkNames) names.absorb(table);
+
+    size_t total = 0;
+    for (const auto& chunk : parsed) total += chunk.size();
+    flights.reserve(flights.size() + total);
+    size_t lineOffset = 0;
+    for (size_t i = 0; i < chunks; i++) {
+        move(parsed[i].begin(), parsed[i].end(), back_inserter(flights));
+        for (size_t line : partial[i].badLines) result.badLines.push_back(lineOffset + line);
+        lineOffset += partial[i].lines;
+    }
+    result.lines += lineOffset;
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    return true;
+}
+
+// The same file through getline/stoi/sscanf, the way inputFlights and processInputData convert fields
+bool loadFlightPlanStream(const string& path, vector<Aircraft>& flights, FlightPlanResult& result)
+{
+    auto started = chrono::steady_clock::now();
+    ifstream file(path);
+    if (!file.is_open()) return false;
+    string line;
+    time_t now = time(nullptr);
+    unsigned seed = rand();
+    while (getline(file, line)) {
+        result.lines++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        stringstream ss(line);
+        string fields[6];
+        int count = 0;
+        while (count < 6 && getline(ss, fields[count], ',')) count++;
+        Aircraft ac;
+        int hh, mm;
+        try {
+            if (count != 6 || !ss.eof() || fields[0].empty()) throw invalid_argument("fields");
+            int type = stoi(fields[2]), direction = stoi(fields[3]), priority = stoi(fields[4]);
+            if (type < 0 || type > 2 || direction < 0 || direction > 3 || priority < 1 || priority > 5 ||
+                sscanf(fields[5].c_str(), "%d:%d", &hh, &mm) != 2 || hh < 0 || hh > 23 || mm < 0 || mm > 59)
+                throw invalid_argument("range");
+            ac.type = static_cast<AircraftType>(type);
+            ac.direction = static_cast<Direction>(direction);
+            ac.priority = priority;
+        } catch (const exception&) {
+            result.badLines.push_back(result.lines);
+            continue;
+        }
+        ac.id = names.intern(fields[0]);
+        ac.airline = names.intern(fields[1]);
+        ac.scheduledTimeStr = names.intern(fields[5]);
+        ac.scheduledMinutes = hh * 60 + mm;
+        initFlightDefaults(ac, now, seed);
+        flights.push_back(ac);
+    }
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    return true;
+}
+
+// --load-bench <file|N>: time both loaders on a plan file (N = write a synthetic plan of N flights first)
+int runLoadBench(string path)
+{
+    if (!path.empty() && path.find_first_not_of("0123456789") == string::npos) {
+        size_t count = stoul(path);
+        path = "flight_plan_bench.csv";
+        ofstream out(path);
+        out << "# FlightID,Airline,Type,Direction,Priority,hh:mm\n";
+        const char* airlines[] = {"PIA", "AirBlue", "FedEx", "PakAirForce", "BlueDart", "AghaKhan"};
+        for (size_t i = 0; i < count; i++) {
+            out << "FL" << i << ',' << airlines[i % 6] << ',' << i % 3 << ',' << (i / 3) % 4 << ','
+                << 1 + i % 5 << ',' << setw(2) << setfill('0') << (i / 60) % 24 << ':' << setw(2) << i % 60 << setfill(' ') << '\n';
+        }
+        cout << "[ATC] Wrote " << count << " synthetic flights to " << path << endl;
+    }
+
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    vector<Aircraft> streamed, mapped;
+    FlightPlanResult streamResult, mappedResult;
+    if (!loadFlightPlanStream(path, streamed, streamResult) ||
+        !loadFlightPlanMapped(path, mapped, mappedResult, threads)) {
+        cerr << "[ATC] Failed to read flight plan " << path << endl;
+        return 1;
+    }
+
+    auto report = [](const char* name, const vector<Aircraft>& flights, const FlightPlanResult& result) {
+        double perMillion = flights.empty() ? 0.0 : result.seconds * 1e6 / flights.size();
+        cout << "[ATC] " << left << setw(22) << name << right << flights.size() << " flights, "
+             << result.badLines.size() << " bad lines, " << fixed << setprecision(3) << result.seconds << " s ("
+             << perMillion << " s per million)" << endl;
+    };
+    report("iostream loader:", streamed, streamResult);
+    report(("mmap loader, " + to_string(threads) + " thr:").c_str(), mapped, mappedResult);
+    if (mappedResult.seconds > 0) {
+        cout << "[ATC] Speedup: " << fixed << setprecision(1) << streamResult.seconds / mappedResult.seconds << "x" << endl;
+    }
+
+    bool same = streamed.size() == mapped.size() && streamResult.badLines == mappedResult.badLines;
+    for (size_t i = 0; same && i < mapped.size(); i++) {
+        same = streamed[i].id == mapped[i].id && streamed[i].airline == mapped[i].airline &&
+               streamed[i].type == mapped[i].type && streamed[i].direction == mapped[i].direction &&
+               streamed[i].priority == mapped[i].priority && streamed[i].scheduledMinutes == mapped[i].scheduledMinutes;
+    }
+    cout << "[ATC] Loaders " << (same ? "agree" : "DISAGREE") << " on every flight" << endl;
+    return same ? 0 : 1;
+}
+
+// Bump allocator for things that only live for one frame. reset() at the start of
+// a frame hands the same blocks out again, so a warm frame never calls new
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t blockSize = 64 * 1024) : blockSize(blockSize) {}
+
+    void reset() { current = 0; used = 0; }
+
+    void* allocate(size_t bytes, size_t align)
+    {
+        while (current < blocks.size()) {
+            size_t start = (used + align - 1) & ~(align - 1);
+            if (start + bytes <= blockSizes[current]) {
+                used = start + bytes;
+                return blocks[current].get() + start;
+            }
+            current++; // the rest of this block is wasted until reset()
+            used = 0;
+        }
+        size_t size = max(blockSize, bytes + align);
+        blocks.emplace_back(new char[size]);
+        blockSizes.push_back(size);
+        current = blocks.size() - 1;
+        used = 0;
+        return allocate(bytes, align);
+    }
+
+    template <typename T>
+    T* alloc(size_t count) { return static_cast<T*>(allocate(count * sizeof(T), alignof(T))); }
+
+    // printf into arena memory; the view is null terminated and valid until reset()
+    string_view format(const char* fmt, ...)
+    {
+        va_list args, retry;
+        va_start(args, fmt);
+        va_copy(retry, args);
+        size_t room = current < blocks.size() ? blockSizes[current] - used : 0;
+        char* out = room ? blocks[current].get() + used : nullptr;
+        int length = vsnprintf(out, room, fmt, args);
+        va_end(args);
+        if (length >= 0 && size_t(length) < room) {
+            used += length + 1;
+        } else if (length >= 0) {
+            out = alloc<char>(length + 1);
+            vsnprintf(out, length + 1, fmt, retry);
+        }
+        va_end(retry);
+        return length < 0 ? string_view() : string_view(out, length);
+    }
+
+    size_t capacity() const
+    {
+        size_t total = 0;
+        for (size_t size : blockSizes) total += size;
+        return total;
+    }
+
+private:
+    size_t blockSize;
+    vector<unique_ptr<char[]>> blocks;
+    vector<size_t> blockSizes;
+    size_t current = 0; // block being bumped
+    size_t used = 0;    // bytes used in it
+};
+
+// sf::Text objects kept from frame to frame. begin() starts a frame, next() hands
+// out the slots in order and only calls setString when the slot shows something else
+class TextPool
+{
+public:
+    void init(const sf::Font& font, unsigned characterSize)
+    {
+        this->font = &font;
+        this->characterSize = characterSize;
+    }
+
+    void reserve(size_t count)
+    {
+        slots.reserve(count);
+        while (slots.size() < count) addSlot();
+    }
+
+    void begin() { used = 0; }
+
+    sf::Text& next(string_view str, float x, float y, sf::Color color)
+    {
+        if (used == slots.size()) addSlot(); // fleet outgrew the pool
+        Slot& slot = slots[used++];
+        if (slot.shown != str) {
+            slot.shown.assign(str.data(), str.size());
+            slot.text.setString(slot.shown);
+        }
+        if (slot.color != color) {
+            slot.color = color;
+            slot.text.setFillColor(color);
+        }
+        slot.text.setPosition(x, y);
+        return slot.text;
+    }
+
+    void draw(sf::RenderTarget& target) const
+    {
+        for (size_t i = 0; i < used; i++) target.draw(slots[i].text);
+    }
+
+    size_t size() const { return slots.size(); }
+
+private:
+    struct Slot {
+        sf::Text text;
+        string shown;
+        sf::Color color;
+    };
+
+    void addSlot()
+    {
+        slots.emplace_back();
+        Slot& slot = slots.back();
+        if (font) slot.text.setFont(*font); //font is only missing if the visualizer failed to load it
+        slot.text.setCharacterSize(characterSize);
+        slot.color = sf::Color::White;
+        slot.text.setFillColor(slot.color);
+        slot.shown.reserve(96); // a status row
+    }
+
+    vector<Slot> slots;
+    size_t used = 0;
+    const sf::Font* font = nullptr;
+    unsigned characterSize = 16;
+};
+
+// Same as TextPool for dots and bars, Size is a circle's radius or a rectangle's size
+template <typename Shape, typename Size>
+class ShapePool
+{
+public:
+    void reserve(size_t count)
     {
-        data.id = "";
-        data.airline = "";
-        data.type = "";
-        data.direction = "";
-        data.priority = "";
-        data.scheduledTime = "";
-        data.currentField = 0;
-        data.complete = false;
-        errorText.setString("");
+        slots.reserve(count);
+        while (slots.size() < count) slots.emplace_back();
+    }
+
+    void begin() { used = 0; }
+
+    Shape& next(Size size, float x, float y, sf::Color color)
+    {
+        if (used == slots.size()) slots.emplace_back();
+        Slot& slot = slots[used++];
+        if (slot.size != size) {
+            slot.size = size;
+            resize(slot.shape, size);
+        }
+        if (slot.color != color) {
+            slot.color = color;
+            slot.shape.setFillColor(color);
+        }
+        slot.shape.setPosition(x, y);
+        return slot.shape;
     }
+
+    void draw(sf::RenderTarget& target) const
+    {
+        for (size_t i = 0; i < used; i++) target.draw(slots[i].shape);
+    }
+
+    size_t size() const { return slots.size(); }
+
+private:
+    struct Slot {
+        Shape shape;
+        Size size{};
+        sf::Color color = sf::Color::White;
+    };
+
+    static void resize(sf::CircleShape& shape, float radius) { shape.setRadius(radius); }
+    static void resize(sf::RectangleShape& shape, sf::Vector2f size) { shape.setSize(size); }
+
+    vector<Slot> slots;
+    size_t used = 0;
 };
 
-void processInputData(AirControlX& atc, const FlightInputData& data) //when u input the data for a slight, initialize aircraft
+// A reader's copy of one runway queue. refresh() compares the queue's version without
+// locking and only copies when it moved: one short critical section that copies the
+// heap's pointers, nothing popped or sorted under the lock. flights[0] pops next;
+// callers sort whatever part of the rest they need themselves, outside any lock.
+struct QueueSnapshot
 {
-    //add one aircradft to the atc at a time
-        Aircraft ac;
-        ac.id = data.id;
-        ac.airline = data.airline;
-        ac.type = static_cast<AircraftType>(stoi(data.type));
-        ac.direction = static_cast<Direction>(stoi(data.direction));
-        ac.priority = stoi(data.priority);
-        ac.scheduledTimeStr = data.scheduledTime;
-
-        //parse time
-        int hh, mm;
-        sscanf(data.scheduledTime.c_str(), "%d:%d", &hh, &mm);
-        ac.scheduledMinutes = hh * 60 + mm;
+    unsigned long version = 0;
+    bool taken = false;
+    vector<const Aircraft*> flights;
+    long copies = 0; //refreshes that had to take the lock
 
-        //set other defaults (module 2 wala code)
-        ac.phase = (ac.direction == NORTH || ac.direction == SOUTH) ? HOLDING : AT_GATE;
-        ac.currentSpeed = (ac.phase == HOLDING) ? 400 + (rand() % 201) : 0;
-        ac.isEmergency = (ac.type == EMERGENCY);
-        ac.hasAVN = false;
-        ac.hasFault = false;
-        ac.lastPhaseChange = time(nullptr);
-        ac.queueEntryTime = time(nullptr);
-        ac.fuelPercentage = (ac.direction == NORTH || ac.direction == SOUTH) ? 
-            (70 + (rand() % 31)) : 100.0;  // b/w 70-100 for arrivals, 100 for departures
-        ac.hadLowFuel = false;
-
-        atc.flights.push_back(ac);
-}
+    // returns true if the copy changed
+    bool refresh(const Runway& runway)
+    {
+        if (taken && runway.queue.version() == version) return false;
+        lock_guard<mutex> lock(runway.queueMutex);
+        version = runway.queue.version();
+        const vector<Aircraft*>& heap = runway.queue.heap();
+        flights.assign(heap.begin(), heap.end());
+        taken = true;
+        copies++;
+        return true;
+    }
+};
 
 //simulation time
 class SimulationVisualizer 
@@ -1440,17 +2968,27 @@ class SimulationVisualizer
     private:
         sf::Font font;
         sf::Font font2;
-        sf::RectangleShape runways[3];
-        vector<sf::CircleShape> flightDots;
-        vector<sf::Text> flightLabels; 
+        vector<sf::RectangleShape> runways; //one per configured runway
+        ShapePool<sf::CircleShape, float> flightDots;       //runway and queue dots, reused every frame
+        ShapePool<sf::RectangleShape, sf::Vector2f> heatBars; //queues too long for dots, one segment per priority
+        TextPool flightLabels;  //id + speed next to a dot on a runway
+        TextPool queueCounts;   //"N queued" over a heat bar
         vector<sf::RectangleShape> queueBoxes;
-        vector<sf::Text> consoleTexts;
         sf::RectangleShape consoleArea;
         int maxConsoleLines = 15;
-        sf::Text runwayLabels[3];
+        vector<sf::Text> runwayLabels;
         sf::Text statusHeader;
-        vector<sf::Text> statusTexts;
+        TextPool statusTexts;   //runway and flight rows
         sf::Text simulationTimeText;
+        int shownTime = -1;     //simulation second simulationTimeText shows
+        FrameArena frame;       //row strings and queue dots, reset every update()
+        vector<QueueSnapshot> queueSnapshots; //one per runway, recopied only when that queue changes
+        size_t tableTop = 0;    //y of the first flight row
+        size_t tableRows = 0;   //flight rows that fit in the console area
+        size_t firstRow = 0;    //active flight shown in the first row (scroll position)
+        size_t tableTotal = 0;  //active flights at the last update()
+        size_t messagesSeen = 0;
+        string latestMessage;
         int consoleX = 50, consoleY = 10; //store console coordintes to easily display output
         int incY = 5; //the number to increment consoleY by for each consecutive output string
         int runwayStartX = 380, runwayStartY = 320;
@@ -1462,7 +3000,26 @@ class SimulationVisualizer
 
         
     public:
-        SimulationVisualizer() 
+        //colours cycle if there are more runways than entries
+        static sf::Color runwayFill(int i)
+        {
+            static const sf::Color fills[] = {
+                sf::Color(115, 147, 179), sf::Color(170, 74, 68), sf::Color(225, 193, 110), //a: blue, b: red, c: yellow
+                sf::Color(120, 170, 110), sf::Color(160, 120, 180), sf::Color(200, 140, 90)
+            };
+            return fills[i % 6];
+        }
+
+        static sf::Color dotColor(int i)
+        {
+            static const sf::Color dots[] = {
+                sf::Color::Blue, sf::Color::Red, sf::Color::Magenta, //magenta to pop
+                sf::Color(0, 128, 0), sf::Color(128, 0, 128), sf::Color(255, 128, 0)
+            };
+            return dots[i % 6];
+        }
+
+        SimulationVisualizer(const AirControlX& atc) 
         {
             if (!font.loadFromFile("Textures/VT323-Regular.ttf")) 
             {
@@ -1495,24 +3052,29 @@ class SimulationVisualizer
             incY += 5;
             statusHeader.setFillColor(sf::Color::White);
             
-            //setup runways (3 rectangles)
-            for (int i = 0; i < 3; i++) 
+            //setup runways, squeezing rows together when there are more than 3
+            const int runwayCount = atc.runways.size();
+            const float runwaySpacing = min(80.0f, 270.0f / runwayCount);
+            const float runwayHeight = min(40.0f, runwaySpacing / 2);
+            const float queueSpacing = min(80.0f, 280.0f / runwayCount);
+            const float queueHeight = runwayCount <= 3 ? 100.0f : queueSpacing - 4;
+            runways.resize(runwayCount);
+            runwayLabels.resize(runwayCount);
+            for (int i = 0; i < runwayCount; i++) 
             {
-                runways[i].setSize(sf::Vector2f(400, 40));
+                runways[i].setSize(sf::Vector2f(400, runwayHeight));
                 runways[i].setOutlineThickness(2);
                 runways[i].setOutlineColor(sf::Color::White);
-                runways[i].setPosition(runwayStartX, runwayStartY + i * 80);
+                runways[i].setPosition(runwayStartX, runwayStartY + i * runwaySpacing);
+                runways[i].setFillColor(runwayFill(i));
             }
-            runways[0].setFillColor(sf::Color(115, 147, 179)); //a: blue
-            runways[1].setFillColor(sf::Color(170, 74, 68)); //b: red
-            runways[2].setFillColor(sf::Color(225, 193, 110)); //c: yellow
 
             
             //setup queue boxes and runways
-            for (int i = 0; i < 3; i++) 
+            for (int i = 0; i < runwayCount; i++) 
             {
-                sf::RectangleShape box(sf::Vector2f(150, 100));
-                box.setPosition(620, 30 + i*80);
+                sf::RectangleShape box(sf::Vector2f(150, queueHeight));
+                box.setPosition(620, 30 + i*queueSpacing);
                 box.setFillColor(sf::Color(0, 0, 0, 150));
                 box.setOutlineThickness(1);
                 box.setOutlineColor(sf::Color::White);
@@ -1522,221 +3084,271 @@ class SimulationVisualizer
                 label.setFont(font);
                 label.setCharacterSize(14);
                 label.setFillColor(sf::Color::White);
-                label.setString(i == 0 ? "Arrival Q" : i == 1 ? "Departure Q" : "Cargo/Emerg Q");
-                label.setPosition(620, 30 + i*80 - 20);  // Slightly above each queue box
+                label.setString(atc.runways[i].config.name + " Q");
+                if (runwayCount <= 3)
+                    label.setPosition(620, 30 + i*queueSpacing - 20);  // Slightly above each queue box
+                else
+                    label.setPosition(620 - 70, 30 + i*queueSpacing);  // no room above, so left of the box
                 queueLabels.push_back(label);
 
 
                  //runway labels
                 runwayLabels[i].setFont(font);
-                runwayLabels[i].setCharacterSize(16);
-                runwayLabels[i].setPosition(runwayStartX + 150, runwayStartY + i * 80);
+                runwayLabels[i].setCharacterSize(runwayCount <= 3 ? 16 : 12);
+                runwayLabels[i].setPosition(runwayStartX + 150, runwayStartY + i * runwaySpacing);
                 runwayLabels[i].setFillColor(sf::Color::Black);
+                runwayLabels[i].setString(atc.runways[i].config.role);
             }
 
-            runwayLabels[0].setString("Arrivals");
-            runwayLabels[1].setString("Departures");
-            runwayLabels[2].setString("Cargo/Emerg");
-
             currentMessage.setFont(font2);
             currentMessage.setCharacterSize(12);
             currentMessage.setPosition(10, 550);
             currentMessage.setFillColor(sf::Color(0, 255, 127)); //spring green
 
+            //the flight table fills the console area under the runway rows, whatever the fleet size
+            tableTop = consoleY + 40 + (runwayCount + 3) * textLineHeight + textLineHeight / 2;
+            tableRows = tableTop < TABLE_BOTTOM ? (TABLE_BOTTOM - tableTop) / textLineHeight : 1;
+
+            //the pools only ever hold what fits on screen, so size them once here
+            size_t queueDots = 0;
+            for (const auto& box : queueBoxes) queueDots += queueCapacity(box);
+            statusTexts.init(font, 16);
+            statusTexts.reserve(3 + runwayCount + tableRows); //3 headers
+            flightLabels.init(font, 16);
+            flightLabels.reserve(runwayCount);
+            queueCounts.init(font, 12);
+            queueCounts.reserve(runwayCount);
+            flightDots.reserve(runwayCount + queueDots);
+            heatBars.reserve(runwayCount * PRIORITY_LEVELS);
+            queueSnapshots.resize(runwayCount);
+            for (auto& snapshot : queueSnapshots) snapshot.flights.reserve(atc.plan.size() / runwayCount + 1);
+        }
+
+        static const size_t TABLE_BOTTOM = 540; //currentMessage sits under this
+        static const int PRIORITY_LEVELS = 5;
+        static const int QUEUE_DOTS_PER_ROW = 5;
+        static constexpr float QUEUE_DOT_SPACING = 25;
+        static constexpr float QUEUE_DOT_SIZE = 8;
+
+        //dots that fit in a queue box before it switches to a count and heat bar
+        static size_t queueCapacity(const sf::RectangleShape& box)
+        {
+            float rowSpace = box.getSize().y - 15 - 2 * QUEUE_DOT_SIZE; //first row starts 15 down
+            return rowSpace < 0 ? 0 : (size_t(rowSpace / QUEUE_DOT_SPACING) + 1) * QUEUE_DOTS_PER_ROW;
+        }
+
+        //priority 1 (green) to 5 (red)
+        static sf::Color heatColor(int priority)
+        {
+            static const sf::Color heat[PRIORITY_LEVELS] = {
+                sf::Color(60, 180, 75), sf::Color(170, 200, 60), sf::Color(240, 210, 50),
+                sf::Color(245, 130, 40), sf::Color(220, 40, 40)
+            };
+            return heat[min(max(priority, 1), PRIORITY_LEVELS) - 1];
+        }
+
+        //scroll the flight table with the mouse wheel, arrows, PageUp/PageDown, Home/End;
+        //returns true if the view has to be updated
+        bool handleEvent(const sf::Event& event)
+        {
+            long step = 0;
+            if (event.type == sf::Event::MouseWheelScrolled)
+            {
+                step = event.mouseWheelScroll.delta > 0 ? -3 : 3;
+            }
+            else if (event.type == sf::Event::KeyPressed)
+            {
+                if (event.key.code == sf::Keyboard::Up) step = -1;
+                else if (event.key.code == sf::Keyboard::Down) step = 1;
+                else if (event.key.code == sf::Keyboard::PageUp) step = -long(tableRows);
+                else if (event.key.code == sf::Keyboard::PageDown) step = tableRows;
+                else if (event.key.code == sf::Keyboard::Home) step = -long(tableTotal);
+                else if (event.key.code == sf::Keyboard::End) step = tableTotal;
+            }
+            size_t lastFirst = tableTotal > tableRows ? tableTotal - tableRows : 0;
+            size_t target = min<long>(max<long>(0, long(firstRow) + step), lastFirst);
+            if (target == firstRow) return false;
+            firstRow = target;
+            return true;
         }
         
         void update(const AirControlX& atc) //, const vector<string>& consoleOutput) 
         {
-            //clear previous
-            flightDots.clear();
-            flightLabels.clear();
-            statusTexts.clear();
-            consoleTexts.clear();
-
-            //update simulation time
-            stringstream timeSS;
-            timeSS << "Simulation Time: " << atc.simulationTime << "/" << SIMULATION_DURATION << " seconds";
-            simulationTimeText.setString(timeSS.str());
+            //start a frame: everything below reuses last frame's memory
+            frame.reset();
+            statusTexts.begin();
+            flightLabels.begin();
+            queueCounts.begin();
+            flightDots.begin();
+            heatBars.begin();
+
+            //update simulation time, only reformatted when the second changes
+            if (atc.simulationTime != shownTime)
+            {
+                shownTime = atc.simulationTime;
+                simulationTimeText.setString(frame.format("Simulation Time: %d/%d seconds", shownTime, SIMULATION_DURATION).data());
+            }
 
              // update runway status
              int textY = consoleY + 40;
-             statusTexts.push_back(createText("=== Runways ===", consoleX, textY));
+             statusTexts.next("=== Runways ===", consoleX, textY, sf::Color::White);
              textY += textLineHeight;
             for (auto& runway : atc.runways) 
             {
-                string status = runway.getName() + ": ";
+                string_view status;
                 if (runway.isOccupied && runway.currentAircraft) 
                 {
-                    status += runway.currentAircraft->id + " (" + runway.currentAircraft->getPhaseString() + ")";
+                    const Aircraft& aircraft = *runway.currentAircraft;
+                    string_view phase = aircraft.getPhaseString();
+                    status = frame.format("%s: %.*s (%.*s)", runway.getName().c_str(),
+                                          int(aircraft.id.size()), aircraft.id.data(), int(phase.size()), phase.data());
                 } 
                 else 
                 {
-                    status += "Available";
+                    status = frame.format("%s: Available", runway.getName().c_str());
                 }
-                sf::Text text(status, font, 16);
-                text.setPosition(consoleX + 10, textY);
-                text.setFillColor(sf::Color::White);
-                statusTexts.push_back(text);
+                statusTexts.next(status, consoleX + 10, textY, sf::Color::White);
                 textY += textLineHeight;
             }
         
+            //copy the runway queues that changed since last frame, one lock at a time and before
+            //displayMutex, so update() never holds two locks at once
+            for (size_t i = 0; i < atc.runways.size(); i++) queueSnapshots[i].refresh(atc.runways[i]);
+
+            //lock display mutex to ensure consistent state cause we r about to access runways and flights
+            lock_guard<mutex> lock(atc.displayMutex);
+
+            //the table is a window of tableRows rows onto atc.activeFlights, starting at firstRow;
+            //only those rows are visited (finished flights are in atc.history)
+            tableTotal = atc.activeFlights.size();
+            firstRow = min(firstRow, tableTotal > tableRows ? tableTotal - tableRows : 0);
+            size_t lastRow = min(firstRow + tableRows, tableTotal);
+
             textY += textLineHeight/2;
-            statusTexts.push_back(createText("=== Active Flights ===", consoleX, textY));
+            if (tableTotal > tableRows)
+                statusTexts.next(frame.format("=== Active Flights %zu-%zu of %zu (scroll) ===", firstRow + 1, lastRow, tableTotal),
+                                 consoleX, textY, sf::Color::White);
+            else
+                statusTexts.next("=== Active Flights ===", consoleX, textY, sf::Color::White);
             textY += textLineHeight;
             
-            sf::Text header("Flight ID  Type        Phase      Speed  Priority  Runway    AVN  Wait(s) Fuel(%)", font, 16);
-            header.setPosition(consoleX + 10, textY);
-            header.setFillColor(sf::Color::White);
-            statusTexts.push_back(header);
+            statusTexts.next("Flight ID  Type        Phase      Speed  Priority  Runway    AVN  Wait(s) Fuel(%)", consoleX + 10, textY, sf::Color::White);
             textY += textLineHeight;
             
-            //update flight details
-            for (auto& flight : atc.flights) 
+            //update flight details, one fixed-width row per flight formatted into the frame arena
+            for (size_t row = firstRow; row < lastRow; row++) 
             {
-                stringstream flightSS;
-                flightSS << left << setw(10) << flight.id.substr(0, 9)
-                << setw(12) << flight.getTypeString().substr(0, 11)
-                << setw(12) << (flight.hasFault ? "TOWED" : flight.getPhaseString().substr(0, 11))
-                << setw(8) << fixed << setprecision(2) << flight.currentSpeed
-                << setw(10) << flight.priority
-                << setw(10) << flight.getRunwayString()
-                << setw(5) << flight.AVNcount //old: (flight.hasAVN ? "Yes" : "No")
-                << setw(8) << fixed << setprecision(2) << flight.waitTime
-                << setw(10) << fixed << setprecision(2) << flight.fuelPercentage;
-                                    
-                sf::Text text(flightSS.str(), font, 16);
-                text.setPosition(consoleX + 10, textY);
-                text.setFillColor(flight.isEmergency ? sf::Color::Red : sf::Color::White); //cahnge color
-                statusTexts.push_back(text);
+                const Aircraft& flight = *atc.activeFlights[row];
+                string_view type = flight.getTypeString();
+                string_view phase = flight.hasFault ? string_view("TOWED") : flight.getPhaseString();
+                string_view runway = flight.getRunwayString();
+                string_view line = frame.format("%-10.*s%-12.*s%-12.*s%-8.2f%-10d%-10.*s%-5d%-8.2f%-10.2f",
+                    int(min<size_t>(flight.id.size(), 9)), flight.id.data(),
+                    int(min<size_t>(type.size(), 11)), type.data(),
+                    int(min<size_t>(phase.size(), 11)), phase.data(),
+                    flight.currentSpeed, flight.priority,
+                    int(runway.size()), runway.data(),
+                    flight.AVNcount, flight.waitTime, flight.fuelPercentage);
+                statusTexts.next(line, consoleX + 10, textY, flight.isEmergency ? sf::Color::Red : sf::Color::White); //cahnge color
                 textY += textLineHeight;
             }
-            
-            //lock display mutex to ensure consistent state cause we r about to access runways and flights
-            lock_guard<mutex> lock(atc.displayMutex);
 
             //runway aircraft + labels
-            for (int i = 0; i < 3; i++) 
+            for (size_t i = 0; i < atc.runways.size(); i++) 
             {
-                if (atc.runways[i].currentAircraft != nullptr) //not using LOCK, but visualize on runway
+                const Aircraft* aircraft = atc.runways[i].currentAircraft;
+                if (aircraft != nullptr) //not using LOCK, but visualize on runway
                 {
-                    sf::CircleShape dot(10);
-                    dot.setPosition(runways[i].getPosition().x + 20, 
-                                runways[i].getPosition().y + 10);
-                    
                     //color coding based on runway
-                    if (i == 0) dot.setFillColor(sf::Color::Blue);    // RWY-A
-                    else if (i == 1) dot.setFillColor(sf::Color::Red); // RWY-B
-                    else dot.setFillColor(sf::Color::Magenta); // RWY-C magenta to pop
-                    
-                    flightDots.push_back(dot);
+                    const float dotX = runways[i].getPosition().x + 20;
+                    const float dotY = runways[i].getPosition().y + 10;
+                    flightDots.next(10, dotX, dotY, dotColor(i));
 
                    //create label for aircraft (ID and speed)
-                    if (atc.runways[i].currentAircraft)
-                    {
-                        string labelText = atc.runways[i].currentAircraft->id + "\n" + to_string((int)atc.runways[i].currentAircraft->currentSpeed) + "km/h";
-                        
-                        sf::Text label;
-                        label.setFont(font); 
-                        label.setString(labelText);
-                        label.setCharacterSize(16);
-                        label.setPosition(dot.getPosition().x + 10, dot.getPosition().y + 10);
-                        label.setFillColor(sf::Color::Green);
-                        flightLabels.push_back(label);
-                    }  
+                    string_view labelText = frame.format("%.*s\n%dkm/h", int(aircraft->id.size()), aircraft->id.data(),
+                                                         (int)aircraft->currentSpeed);
+                    flightLabels.next(labelText, dotX + 10, dotY + 10, sf::Color::Green);
                 }
             }
             
-            // Update queue aircraft
-            vector<vector<const Aircraft*>> queuedFlights(3);
-        
-            //get flights from each queue
-            {                
-                lock_guard<mutex> lock1(atc.arrivalQueueMutex);
-                lock_guard<mutex> lock2(atc.departureQueueMutex);
-                lock_guard<mutex> lock3(atc.cargoQueueMutex); 
-                            
-                
-                auto tempArrival = atc.arrivalQueue;
-                while (!tempArrival.empty())
-                {
-                    queuedFlights[RWY_A].push_back(tempArrival.top());
-                    tempArrival.pop();
-                }
-                
-                auto tempDeparture = atc.departureQueue;
-                while (!tempDeparture.empty()) 
-                {
-                    queuedFlights[RWY_B].push_back(tempDeparture.top());
-                    tempDeparture.pop();
-                }
-                
-                auto tempCargo = atc.cargoEmergencyQueue;
-                while (!tempCargo.empty()) 
-                {
-                    queuedFlights[RWY_C].push_back(tempCargo.top());
-                    tempCargo.pop();
-                }
-            }
-        
-            //create dots and labels in queue boxes
-            for (int runwayIdx = 0; runwayIdx < 3; runwayIdx++)
+            //flights on a runway are drawn there, not in their queue box
+            const Aircraft* onRunway[MAX_RUNWAYS];
+            for (size_t i = 0; i < atc.runways.size(); i++) onRunway[i] = atc.runways[i].currentAircraft;
+            auto waiting = [&](const Aircraft* flight) {
+                if (flight->hasFault) return false; //skip drawing towed flights
+                if (flight->phase == LANDING || flight->phase == TAKEOFF_ROLL || flight->phase == TAXI) return false;
+                return find(onRunway, onRunway + atc.runways.size(), flight) == onRunway + atc.runways.size();
+            };
+
+            //queue boxes, from the snapshots with no queue lock held. A queue that fits its box is
+            //drawn as dots in pop order, a longer one as a count and a heat bar split by priority,
+            //so one pass over the queue is all a box costs however long the queue gets
+            for (size_t runwayIdx = 0; runwayIdx < atc.runways.size(); runwayIdx++)
             {
-                const auto& queue = queuedFlights[runwayIdx];
-                const float boxWidth = queueBoxes[runwayIdx].getSize().x;
-                const float boxHeight = queueBoxes[runwayIdx].getSize().y;
-                const float startX = queueBoxes[runwayIdx].getPosition().x + 10;
-                const float startY = queueBoxes[runwayIdx].getPosition().y + 15;
-
-                //keep track of flight dots so they dont overflow
-                const int maxDotsPerRow = 5;  
-                const float dotSpacing = 25; 
-                const float dotSize = 8;   
-                
-                for (size_t i = 0; i < queue.size(); i++) 
+                const sf::RectangleShape& box = queueBoxes[runwayIdx];
+                const size_t capacity = queueCapacity(box);
+                const Aircraft** shown = frame.alloc<const Aircraft*>(capacity);
+                size_t shownCount = 0, waitingCount = 0, emergencies = 0;
+                size_t byPriority[PRIORITY_LEVELS] = {};
+                for (const Aircraft* flight : queueSnapshots[runwayIdx].flights)
                 {
-                    const auto& flight = queue[i];
-                    if (flight->hasFault) continue; //skip drawing towed flights
+                    if (!waiting(flight)) continue;
+                    waitingCount++;
+                    byPriority[min(max(flight->priority, 1), PRIORITY_LEVELS) - 1]++;
+                    emergencies += flight->isEmergency;
+                    if (shownCount < capacity) shown[shownCount++] = flight;
+                }
 
-                    //check if flight is already on a runway
-                    bool isOnRunway = false;
-                    for (const auto& runway : atc.runways) 
+                const float startX = box.getPosition().x + 10;
+                const float startY = box.getPosition().y + 15;
+                if (waitingCount <= capacity)
+                {
+                    //the queue pops its comparator's largest first
+                    sort(shown, shown + shownCount, [](const Aircraft* a, const Aircraft* b) {
+                        return AircraftComparator()(b, a);
+                    });
+                    for (size_t i = 0; i < shownCount; i++)
                     {
-                        if (runway.currentAircraft == flight ||
-                            (flight->phase == LANDING || flight->phase == TAKEOFF_ROLL || flight->phase == TAXI))
-                        {
-                            isOnRunway = true;
-                            break;
-                        }
+                         //calculate position so they start "wrapping around" growing leftwards
+                        int row = i / QUEUE_DOTS_PER_ROW;
+                        int col = i % QUEUE_DOTS_PER_ROW;
+
+                        //color code by runway
+                        flightDots.next(QUEUE_DOT_SIZE, startX + col * QUEUE_DOT_SPACING, startY + row * QUEUE_DOT_SPACING, dotColor(runwayIdx));
                     }
-                    if (isOnRunway) continue; //skip flights already on a runway
+                    continue;
+                }
 
-                     //calculate position so they start "wrapping around" growing leftwards
-                    int row = i / maxDotsPerRow;
-                    int col = i % maxDotsPerRow;
-                    sf::CircleShape dot(dotSize);
-                    dot.setPosition(startX + col * dotSpacing, startY + row * dotSpacing);
-                    
-                    //color code by runway
-                    if (runwayIdx == 0) dot.setFillColor(sf::Color::Blue);
-                    else if (runwayIdx == 1) dot.setFillColor(sf::Color::Red);
-                    else dot.setFillColor(sf::Color::Magenta);
-                    
-                    flightDots.push_back(dot);
+                string_view count = emergencies
+                    ? frame.format("%zu queued, %zu emergency", waitingCount, emergencies)
+                    : frame.format("%zu queued", waitingCount);
+                queueCounts.next(count, box.getPosition().x + 5, box.getPosition().y + 1, sf::Color::White);
+
+                //heat bar along the bottom of the box, highest priority (pops first) on the left
+                const float barWidth = box.getSize().x - 10;
+                const float barHeight = min(8.0f, box.getSize().y / 4);
+                const float barY = box.getPosition().y + box.getSize().y - barHeight - 2;
+                float barX = box.getPosition().x + 5;
+                for (int priority = PRIORITY_LEVELS; priority >= 1; priority--)
+                {
+                    size_t n = byPriority[priority - 1];
+                    if (n == 0) continue;
+                    float width = barWidth * n / waitingCount;
+                    heatBars.next(sf::Vector2f(width, barHeight), barX, barY, heatColor(priority));
+                    barX += width;
                 }
             }
 
-           currentMessage.setString(atc.getLatestMessage()); //get latest msg to output only
+           //get latest msg to output only, copied only when something new was logged
+           size_t logged = atc.latestMessageSince(messagesSeen, latestMessage);
+           if (logged != messagesSeen)
+           {
+               messagesSeen = logged;
+               currentMessage.setString(latestMessage);
+           }
         }
 
-        sf::Text createText(const string& str, float x, float y) //helper function to create and set positon of text
-        {
-            sf::Text text(str, font, 16);
-            text.setPosition(x, y);
-            text.setFillColor(sf::Color::White);
-            return text;
-        }
-        
-        void draw(sf::RenderWindow& window) 
+        void draw(sf::RenderTarget& window) 
         {
             
             //draw queue boxes
@@ -1759,9 +3371,9 @@ class SimulationVisualizer
              }
 
              //draw queue and runway labels
-            for (int i = 0; i < 3; i++) 
+            for (auto& label : runwayLabels) 
             {
-                window.draw(runwayLabels[i]);
+                window.draw(label);
             }
             for (const auto& label : queueLabels)
             {
@@ -1769,70 +3381,455 @@ class SimulationVisualizer
             }
 
             //draw flight dots at the end so they r on top of evetryhing
-            for (auto& dot : flightDots) 
-            {
-                window.draw(dot);
+            heatBars.draw(window);
+            queueCounts.draw(window);
+            flightDots.draw(window);
+            flightLabels.draw(window); //put labels on top too
+
+            //except dfor the texts - those r even higher
+            statusTexts.draw(window);
+        }
+};
+
+// Paces the GUI loop. A frame is drawn only when something on screen changed
+// (invalidate()), at most fps times a second, and the loop sleeps until its next
+// slot instead of spinning, so an idle window costs almost no CPU. With vsync on,
+// display() also waits for the monitor. fps 0 means uncapped: frames are drawn as
+// fast as they are invalidated and an idle loop checks for events every IDLE_POLL_MS.
+class FrameScheduler
+{
+public:
+    static const int IDLE_POLL_MS = 10;
+
+    FrameScheduler(sf::RenderWindow& window, unsigned fps, bool vsync)
+        : capped(fps > 0),
+          period(fps > 0 ? chrono::microseconds(1000000 / fps) : chrono::microseconds(IDLE_POLL_MS * 1000)),
+          next(chrono::steady_clock::now()), started(next)
+    {
+        //sfml's own setFramerateLimit is not used, it would sleep on top of this
+        window.setVerticalSyncEnabled(vsync);
+    }
+
+    void invalidate() { dirty = true; }
+    bool frameDue() const { return dirty; }
+
+    void drawn()
+    {
+        dirty = false;
+        drewFrame = true;
+        framesDrawn++;
+    }
+
+    void waitForNextFrame()
+    {
+        auto now = chrono::steady_clock::now();
+        if (!drewFrame) idleSlots++;
+        if (capped) {
+            next += period;
+            if (next < now) next = now; //fell behind, do not catch up with a burst of frames
+            this_thread::sleep_until(next);
+        } else if (!drewFrame) {
+            this_thread::sleep_for(period);
+        }
+        drewFrame = false;
+    }
+
+    void report() const
+    {
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        cout << "[ATC] GUI drew " << framesDrawn << " frames in " << fixed << setprecision(1) << seconds
+             << " s, " << idleSlots << " frame slots idle" << endl;
+    }
+
+private:
+    bool capped;
+    chrono::microseconds period;
+    chrono::steady_clock::time_point next, started;
+    bool dirty = true;
+    bool drewFrame = false;
+    unsigned long framesDrawn = 0, idleSlots = 0;
+};
+
+// Show a fixed screen for a while (splash/transition screens) without spinning:
+// drawScreen runs when the scheduler says the screen needs drawing, in between the
+// loop sleeps. Returns false if the window was closed meanwhile.
+template <typename DrawScreen>
+bool holdScreen(sf::RenderWindow& window, FrameScheduler& frames, float seconds, DrawScreen drawScreen)
+{
+    auto until = chrono::steady_clock::now() + chrono::duration<float>(seconds);
+    frames.invalidate();
+    while (window.isOpen() && chrono::steady_clock::now() < until)
+    {
+        sf::Event event;
+        while (window.pollEvent(event))
+        {
+            if (event.type == sf::Event::Closed)
+                window.close();
+            frames.invalidate();
+        }
+        if (window.isOpen() && frames.frameDue())
+        {
+            drawScreen();
+            window.display();
+            frames.drawn();
+        }
+        frames.waitForNextFrame();
+    }
+    return window.isOpen();
+}
+
+// Renders the simulation view offscreen at a fixed frame rate and writes the frames
+// out, as numbered PNGs in a directory or as one raw RGBA stream (for ffmpeg). The
+// render thread reads the simulation the same way the window does; encoding and disk
+// writes run on a second thread behind a short queue. A frame that finds the queue
+// full is dropped and counted, so a slow disk never holds up rendering or the sim.
+class FrameExporter
+{
+public:
+    static const size_t QUEUE_FRAMES = 4;
+
+    FrameExporter(const AirControlX& atc, unsigned fps) : atc(atc), fps(max(1u, fps)) {}
+    ~FrameExporter() { stop(); }
+
+    // frame_000000.png, frame_000001.png, ... in dir (created if missing)
+    bool openPngSequence(const string& dir)
+    {
+        if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) return false;
+        pngDir = dir;
+        return true;
+    }
+
+    // every frame's pixels back to back, resolutionX x resolutionY RGBA; path can be a FIFO
+    bool openRawStream(const string& path)
+    {
+        raw = fopen(path.c_str(), "wb");
+        return raw != nullptr;
+    }
+
+    bool isOpen() const { return raw || !pngDir.empty(); }
+
+    void start()
+    {
+        if (!isOpen() || renderThread.joinable()) return;
+        stopping = false;
+        writeThread = thread(&FrameExporter::writeLoop, this);
+        renderThread = thread(&FrameExporter::renderLoop, this);
+    }
+
+    // renders one last frame, waits for the queue to drain and prints what was exported
+    void stop()
+    {
+        if (!renderThread.joinable()) return;
+        stopping = true;
+        renderThread.join();
+        {
+            lock_guard<mutex> lock(queueMutex);
+            rendered = true; //nothing more is coming
+        }
+        queueReady.notify_one();
+        writeThread.join();
+        if (raw) fclose(raw);
+        raw = nullptr;
+        cout << "[ATC] Exported " << written << " frames at " << fps << " fps to "
+             << (pngDir.empty() ? "raw stream" : pngDir) << " (" << dropped << " dropped, "
+             << failed << " failed), render p50 " << renderTime.percentile(50) << " us, max "
+             << renderTime.max() << " us" << endl;
+    }
+
+private:
+    struct Frame {
+        unsigned long number;
+        shared_ptr<const sf::Image> image; //shared when the view did not change since the last frame
+    };
+
+    void renderLoop()
+    {
+        sf::RenderTexture target;
+        if (!target.create(resolutionX, resolutionY)) {
+            cerr << "[ATC] Failed to create an offscreen render target, nothing is exported" << endl;
+            return;
+        }
+        sf::Texture backgroundTexture;
+        sf::Sprite backgroundSprite;
+        bool background = backgroundTexture.loadFromFile("Textures/gridBackground.png");
+        if (background) {
+            backgroundSprite.setTexture(backgroundTexture);
+            backgroundSprite.setColor(sf::Color(255, 255, 255, 255 * 0.50)); //same as the window
+        }
+        SimulationVisualizer view(atc);
+
+        const auto period = chrono::microseconds(1000000 / fps);
+        auto next = chrono::steady_clock::now();
+        unsigned long number = 0, shownVersion = 0;
+        shared_ptr<const sf::Image> image;
+        bool sawRunning = false;
+        while (true) {
+            bool last = stopping || (sawRunning && !atc.simulationRunning);
+            sawRunning = sawRunning || atc.simulationRunning;
+
+            //re-render only when the simulation published something new, otherwise repeat the frame
+            unsigned long version = atc.viewVersion;
+            if (!image || version != shownVersion) {
+                int64_t started = trace_now_us();
+                shownVersion = version;
+                view.update(atc);
+                target.clear();
+                if (background) target.draw(backgroundSprite);
+                view.draw(target);
+                target.display();
+                image = make_shared<const sf::Image>(target.getTexture().copyToImage());
+                renderTime.add(trace_now_us() - started);
             }
-            for (auto & label : flightLabels) //put labels on top too
+
             {
-                window.draw(label);
-            } 
+                lock_guard<mutex> lock(queueMutex);
+                if (queue.size() < QUEUE_FRAMES) queue.push_back({number, image});
+                else dropped++;
+            }
+            queueReady.notify_one();
+            number++;
+            if (last) break;
+
+            next += period;
+            auto now = chrono::steady_clock::now();
+            if (next < now) next = now; //running late, keep the rate rather than bursting
+            this_thread::sleep_until(next);
+        }
+    }
 
-            //except dfor the texts - those r even higher
-            for (auto& textS : statusTexts) 
+    void writeLoop()
+    {
+        char name[32];
+        while (true) {
+            Frame frame;
             {
-                window.draw(textS);
+                unique_lock<mutex> lock(queueMutex);
+                queueReady.wait(lock, [&]() { return !queue.empty() || rendered; });
+                if (queue.empty()) break;
+                frame = move(queue.front());
+                queue.pop_front();
             }
+            bool ok;
+            if (raw) {
+                const sf::Uint8* pixels = frame.image->getPixelsPtr();
+                size_t bytes = size_t(resolutionX) * resolutionY * 4;
+                ok = pixels && fwrite(pixels, 1, bytes, raw) == bytes;
+            } else {
+                snprintf(name, sizeof(name), "/frame_%06lu.png", frame.number);
+                ok = frame.image->saveToFile(pngDir + name);
+            }
+            if (ok) written++;
+            else failed++;
         }
+        if (raw) fflush(raw);
+    }
+
+    const AirControlX& atc;
+    unsigned fps;
+    string pngDir;
+    FILE* raw = nullptr;
+    thread renderThread, writeThread;
+    atomic<bool> stopping{false};
+    mutex queueMutex;
+    condition_variable queueReady;
+    deque<Frame> queue;    //rendered frames waiting for the writer (guarded by queueMutex)
+    bool rendered = false; //render thread is done (guarded by queueMutex)
+    unsigned long written = 0, failed = 0, dropped = 0;
+    LatencyHistogram renderTime;
 };
 
-int main() 
+// --frame-bench [N]: time SimulationVisualizer update + draw for a fleet of N
+// synthetic flights (default: 1000 and 10000) rendered offscreen, and count the
+// heap allocations each frame makes
+int runFrameBench(const vector<size_t>& fleets)
+{
+    const int WARMUP_FRAMES = 30, FRAMES = 300;
+    for (size_t fleet : fleets) {
+        AirControlX atc(false);
+        atc.plan.reserve(fleet);
+        unsigned seed = 42;
+        time_t now = time(nullptr);
+        const char* airlines[] = {"PIA", "AirBlue", "FedEx", "PakAirForce", "BlueDart", "AghaKhan"};
+        for (size_t i = 0; i < fleet; i++) {
+            Aircraft ac;
+            ac.id = names.intern("FL" + to_string(i));
+            ac.airline = names.intern(airlines[i % 6]);
+            ac.type = static_cast<AircraftType>(i % 3);
+            ac.direction = static_cast<Direction>((i / 3) % 4);
+            ac.priority = 1 + i % 5;
+            ac.scheduledMinutes = static_cast<int>(i % 1440);
+            initFlightDefaults(ac, now, seed);
+            atc.plan.push_back(ac);
+        }
+        atc.mapScheduledTimes();
+        atc.scheduleFlights();
+        atc.admitFlights(SIMULATION_DURATION); // the whole fleet on screen at once
+        // put someone on every runway so the runway rows and labels are drawn too
+        for (auto& runway : atc.runways) {
+            Aircraft* top = runway.queue.empty() ? nullptr : runway.queue.top();
+            runway.currentAircraft = top;
+            runway.isOccupied = top != nullptr;
+        }
+
+        SimulationVisualizer visualizer(atc);
+        sf::RenderTexture target;
+        if (!target.create(resolutionX, resolutionY)) {
+            cerr << "[ATC] Failed to create an offscreen render target" << endl;
+            return 1;
+        }
+
+        vector<double> frameMs;
+        unsigned long allocations = 0;
+        for (int frame = 0; frame < WARMUP_FRAMES + FRAMES; frame++) {
+            // at 60 fps the sim ticks every 60 frames, move every flight's numbers then
+            if (frame % 60 == 0) {
+                for (auto& flight : atc.flights) {
+                    flight.currentSpeed = rand_r(&seed) % 900;
+                    flight.fuelPercentage = rand_r(&seed) % 100;
+                }
+                atc.simulationTime++;
+            }
+            unsigned long allocationsBefore = threadAllocations;
+            auto started = chrono::steady_clock::now();
+            target.clear();
+            visualizer.update(atc);
+            visualizer.draw(target);
+            target.display();
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+            if (frame >= WARMUP_FRAMES) {
+                frameMs.push_back(ms);
+                allocations += threadAllocations - allocationsBefore;
+            }
+        }
+
+        double mean = 0, variance = 0;
+        for (double ms : frameMs) mean += ms;
+        mean /= frameMs.size();
+        for (double ms : frameMs) variance += (ms - mean) * (ms - mean);
+        double jitter = sqrt(variance / frameMs.size());
+        sort(frameMs.begin(), frameMs.end());
+        cout << "[ATC] Frame bench, " << fleet << " flights, " << FRAMES << " frames: "
+             << fixed << setprecision(3) << "p50 " << frameMs[frameMs.size() / 2] << " ms, p99 "
+             << frameMs[frameMs.size() * 99 / 100] << " ms, max " << frameMs.back() << " ms, jitter (stddev) "
+             << jitter << " ms, " << setprecision(1) << double(allocations) / FRAMES << " allocations/frame" << endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) 
 {
     srand(time(nullptr));
+
+    // --load-bench <file|N>: compare the flight plan loaders and exit
+    if (argc > 2 && string(argv[1]) == "--load-bench") return runLoadBench(argv[2]);
+    // --frame-bench [N]: time the simulation view's frames and exit
+    if (argc > 1 && string(argv[1]) == "--frame-bench") {
+        if (argc > 2) return runFrameBench({static_cast<size_t>(max(1, atoi(argv[2])))});
+        return runFrameBench({1000, 10000});
+    }
+
     AirControlX atc;
 
     // --------------------- AVN GENERATOR PROCESS CODE --------------------
-    pid_t pid;
-    // Setup pipe
-    if (pipe(atc.pipe_fd) == -1) 
+    // Fork AVN Generator (stdin is the AVN pipe); the emitter's writer thread
+    // watches it from here on and starts a new one if it dies
+    if (!atc.avnGenerator.start("./avn_generator"))
     {
-        std::cerr << "[ATC] Failed to create pipe" << std::endl;
+        std::cerr << "[ATC] Failed to start the AVN generator" << std::endl;
         return 1;
     }
 
-    // Fork AVN Generator
-    pid = fork();
-    if (pid < 0) 
-    {
-        std::cerr << "[ATC] Fork failed" << std::endl;
+    // --avn-overflow block|drop|spill: what happens to AVNs when the generator falls
+    // behind and the emitter's ring fills up (default spill, nothing is lost)
+    AvnOverflowPolicy avnOverflow = AVN_SPILL;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (string(argv[i]) != "--avn-overflow") continue;
+        string policy = argv[i + 1];
+        if (policy == "block") avnOverflow = AVN_BLOCK;
+        else if (policy == "drop") avnOverflow = AVN_DROP_OLDEST;
+        else if (policy != "spill") cerr << "[ATC] Unknown --avn-overflow " << policy << ", using spill" << endl;
+    }
+    if (!atc.avnEmitter.open(atc.avnGenerator, avnOverflow)) {
+        cerr << "[ATC] Failed to set up the AVN pipe" << endl;
         return 1;
     }
-    else if (pid == 0) 
-    {
-        // Child Process: AVN Generator
 
-        // Redirect pipe read end to stdin
-        close(atc.pipe_fd[1]); // Close write end
-
-        if (dup2(atc.pipe_fd[0], STDIN_FILENO) == -1) 
-        {
-            std::cerr << "[AVN Generator] Failed to redirect stdin" << std::endl;
+    // --plan <file>: take the flights from a plan file instead of the input screen
+    bool planLoaded = false;
+    const char* planPath = nullptr;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (string(argv[i]) == "--plan") planPath = argv[i + 1];
+    }
+    if (planPath) {
+        FlightPlanResult plan;
+        if (!loadFlightPlanMapped(planPath, atc.plan, plan, max(1u, thread::hardware_concurrency()))) {
+            cerr << "[ATC] Failed to read flight plan " << planPath << endl;
+            return 1;
+        }
+        cout << "[ATC] Loaded " << atc.plan.size() << " flights from " << planPath << " in "
+             << fixed << setprecision(3) << plan.seconds << " s" << endl;
+        for (size_t i = 0; i < plan.badLines.size() && i < 10; i++) {
+            cerr << "[ATC] Skipped bad line " << plan.badLines[i] << " in " << planPath << endl;
+        }
+        if (atc.plan.size() > static_cast<size_t>(MAX_PLAN_FLIGHTS)) {
+            cerr << "[ATC] " << atc.plan.size() << " flights is more than the " << MAX_PLAN_FLIGHTS
+                 << " a plan can run with (one radar thread per flight); use --load-bench to time big plans" << endl;
             return 1;
         }
+        if (atc.plan.size() > static_cast<size_t>(MAX_ACTIVE_FLIGHTS)) {
+            cerr << "[ATC] Warning: " << atc.plan.size() << " flights is more than the " << MAX_ACTIVE_FLIGHTS
+                 << " the simulation is tuned for (one radar thread per flight)" << endl;
+        }
+        planLoaded = !atc.plan.empty();
+    }
 
-        close(atc.pipe_fd[0]); // Close read end
 
-        execl("./avn_generator", "./avn_generator", (char*)NULL);
-        std::cerr << "[AVN Generator] execl failed" << std::endl;
+    // --render-out DIR (PNG sequence) or --render-raw FILE (raw RGBA stream) export the
+    // simulation view offscreen at --render-fps frames a second; --headless runs the plan
+    // with no window at all, for batch runs on machines without a display
+    bool headless = false;
+    string renderDir, renderRaw;
+    unsigned renderFps = DEFAULT_EXPORT_FPS;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--headless") headless = true;
+        else if (arg == "--render-out" && i + 1 < argc) renderDir = argv[++i];
+        else if (arg == "--render-raw" && i + 1 < argc) renderRaw = argv[++i];
+        else if (arg == "--render-fps" && i + 1 < argc) renderFps = max(1, atoi(argv[++i]));
+    }
+    FrameExporter exporter(atc, renderFps);
+    if (!renderDir.empty() && !exporter.openPngSequence(renderDir)) {
+        cerr << "[ATC] Failed to create frame directory " << renderDir << endl;
+        return 1;
+    }
+    if (!renderRaw.empty() && !exporter.openRawStream(renderRaw)) {
+        cerr << "[ATC] Failed to open raw frame stream " << renderRaw << endl;
         return 1;
     }
 
-    // Parent continues
-    close(atc.pipe_fd[0]); // Close read end in parent (only writing to pipe)
-
+    if (headless) {
+        if (!planLoaded) {
+            cerr << "[ATC] --headless needs a flight plan (--plan <file>)" << endl;
+            return 1;
+        }
+        atc.mapScheduledTimes();
+        atc.scheduleFlights();
+        exporter.start();
+        atc.startSimulation();
+        exporter.stop();
+        return 0;
+    }
 
     // --------------GRAPHICAL SIMULATION CODE------------------
 
+    // --fps N caps the frame rate (default 60, 0 = uncapped), --vsync syncs frames to the monitor
+    unsigned frameCap = DEFAULT_FRAME_CAP;
+    bool vsync = false;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--fps" && i + 1 < argc) frameCap = max(0, atoi(argv[++i]));
+        else if (string(argv[i]) == "--vsync") vsync = true;
+    }
+
     //initialize window
     sf::RenderWindow window(sf::VideoMode(resolutionX, resolutionY), "AirControlX Simulation", sf::Style::Close | sf::Style::Titlebar);
 	window.setPosition(sf::Vector2i(100, 100)); //choose launch point of screen
@@ -1856,117 +3853,122 @@ int main()
         return -1;
     }
 
-    bool inputComplete = false; //track input to switch to simulation
+    bool inputComplete = planLoaded; //track input to switch to simulation (a plan file skips the input screen)
     bool simulationStarted = false;
     InputHandler handleInput;
-    SimulationVisualizer simulation;
+    SimulationVisualizer simulation(atc);
+    FrameScheduler frames(window, frameCap, vsync);
+    unsigned long shownVersion = 0; //atc.viewVersion the simulation view was last updated for
+    bool shownComplete = false;
+
+    //completion screen, the summary is always the last atc message
+    sf::Text completionText("Simulation Complete!", font, 30);
+    completionText.setPosition(10, 250);
+    completionText.setFillColor(sf::Color::Green);
+    sf::Text summaryText("", font, 15);
+    summaryText.setPosition(10, 290);
+    summaryText.setFillColor(sf::Color::White);
+
     while (window.isOpen()) 
 	{
-		window.draw(backgroundSprite);
-
         sf::Event e;
+        bool scrolled = false;
         while (window.pollEvent(e)) 
 		{
             
 			if (e.type == sf::Event::Closed)
 			{
+                frames.report();
+                exporter.stop();
 				return 0;
 			}
 
             if (!inputComplete) //handle whatever was inputted
                 handleInput.handleEvent(e);
+            else if (simulation.handleEvent(e)) //scrolling the flight table
+                scrolled = true;
+            frames.invalidate(); //typing, focus, etc. can all change what is on screen
 			
 		}
 
-        window.clear();	
-
-        window.draw(backgroundSprite);
+        if (!inputComplete && handleInput.data.complete) //all flight data entered
+        {
+            for (auto& flightData : allFlightInputs)
+                processInputData(atc, flightData); //send data to atc per flight
+            
+            inputComplete = true; //start simulation instead
+
+            //mimic sleep for aabia ma'am
+            sf::Text switchText("Simulation starting....", font, 30);
+            switchText.setPosition(10, 250);
+            switchText.setFillColor(sf::Color::Green);
+            bool open = holdScreen(window, frames, 4.0f, [&]() {
+                window.clear(backgroundSprite.getColor());
+                window.draw(backgroundSprite);
+                window.draw(switchText);
+            });
+            if (!open) break;
+        }
 
+        if (inputComplete && !simulationStarted) 
+        {
+            simulationStarted = true;
+            atc.mapScheduledTimes();
+
+            atc.scheduleFlights();
+            // Start simulation in a separate thread
+            thread([&]() {
+                atc.startSimulation();
+            }).detach();
+            exporter.start(); //no-op unless --render-out/--render-raw was given
+            shownVersion = atc.viewVersion - 1; //show the first frame right away
+        }
 
-        if (!inputComplete) 
+        //the simulation view only changes when the simulation publishes something new
+        if (simulationStarted)
         {
-            handleInput.draw(window); //draw ui
-            if (handleInput.data.complete) //all flight data entered
+            unsigned long version = atc.viewVersion;
+            if (version != shownVersion || scrolled)
             {
-                for (auto& flightData : allFlightInputs)
-                    processInputData(atc, flightData); //send data to atc per flight
-                
-                inputComplete = true; //start simulation instead
-                
-                window.clear();
-
-                //mimic sleep for aabia ma'am
-                sf::Clock delayClock;
-                while (delayClock.getElapsedTime().asSeconds() < 4.0f)
-                 {
-                    sf::Text switchText("Simulation starting....", font, 30);
-                    switchText.setPosition(10, 250);
-                    switchText.setFillColor(sf::Color::Green);
-                    window.clear(backgroundSprite.getColor());
-                    window.draw(backgroundSprite);
-                    window.draw(switchText);
-                    window.display();
+                shownVersion = version;
+                if (atc.simulationComplete)
+                {
+                    shownComplete = true;
+                    summaryText.setString(atc.getLatestMessage());
                 }
-
+                else
+                {
+                    simulation.update(atc);
+                }
+                frames.invalidate();
             }
         }
-       else
-       {
-            if (!simulationStarted) 
-            {
-                simulationStarted = true;
-                atc.mapScheduledTimes();
 
-                atc.scheduleFlights();
-                // Start simulation in a separate thread
-                thread([&]() {
-                    atc.startSimulation();
-                }).detach();
+        if (frames.frameDue())
+        {
+            window.clear();
+            window.draw(backgroundSprite);
+            if (!inputComplete)
+            {
+                handleInput.draw(window); //draw ui
             }
-            simulation.update(atc);
-            simulation.draw(window);
-
-            static bool shownCompleteMessage = false; //because adding the child makes this auto close
-            if (simulationStarted && atc.simulationComplete) 
+            else if (shownComplete) //the completion message stays up until the window is closed
             {
-
-                //show the completion message for 5 seconds
-                sf::Clock waitClock;
-                while (waitClock.getElapsedTime().asSeconds() < 5.0f && window.isOpen()) 
-                {
-                    sf::Event event;
-                    while (window.pollEvent(event)) 
-                    {
-                        if (event.type == sf::Event::Closed)
-                            window.close();
-                    }
-
-                    window.clear();
-                    window.draw(backgroundSprite);
-                
-                    //show completion message
-                    sf::Text completionText("Simulation Complete!", font, 30);
-                    completionText.setPosition(10, 250);
-                    completionText.setFillColor(sf::Color::Green);
-                    window.draw(completionText);
-                    //show summary message which is always the last atc message
-                    sf::Text summaryText(atc.getLatestMessage(), font, 15);
-                    summaryText.setPosition(10, 290);
-                    summaryText.setFillColor(sf::Color::White);
-                    window.draw(summaryText);
-
-                    window.display();
-
-                }
+                window.draw(completionText);
+                window.draw(summaryText);
             }
-        
+            else
+            {
+                simulation.draw(window);
+            }
+            window.display();
+            frames.drawn();
         }
-
-        window.display();
-        window.clear();
-
+        frames.waitForNextFrame();
     }
 
+    frames.report();
+    exporter.stop();
     return 0;
 }
 
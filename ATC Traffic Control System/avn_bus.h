@@ -0,0 +1,246 @@
+//AABIA ALI 23I-0704
+//INSHARAH IRFAN 23I-0615
+//CS-D
+
+// Shared memory AVN bus: one ring buffer in /dev/shm written by avn_generator
+// and read by airline_portal and stripe_pay, each with its own cursor.
+//
+// Records are framed as [u32 length][u32 flags][u64 publish time][payload][pad to 8 bytes].
+// Positions are logical byte offsets that only ever grow, physical = offset % capacity.
+// The producer never blocks: when the ring is full it moves `tail` past the
+// oldest records before overwriting them, and a reader that falls behind
+// skips forward to `tail` and counts what it lost.
+
+#ifndef AVN_BUS_H
+#define AVN_BUS_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+const char* const AVN_BUS_NAME = "/avn_bus";         // shows up as /dev/shm/avn_bus
+const uint64_t AVN_BUS_CAPACITY = 4 * 1024 * 1024;  // ring size in bytes, multiple of 8
+const uint32_t AVN_BUS_MAGIC = 0x41564E42;          // "AVNB"
+const uint32_t AVN_BUS_VERSION = 2;                  // bump when the record layout changes
+const uint32_t AVN_RECORD_PAD = 1;                   // flag: filler up to the end of the ring, skip it
+
+struct AvnBusHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    alignas(64) std::atomic<uint64_t> head;  // offset where the next record will be written
+    alignas(64) std::atomic<uint64_t> tail;  // offset of the oldest record still intact
+};
+
+struct AvnRecordHeader {
+    uint32_t length;
+    uint32_t flags;
+    uint64_t publish_ns;  // CLOCK_REALTIME when published, lets readers measure their lag
+};
+
+inline uint64_t avn_bus_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+// A record handed out by the reader, pointing straight into shared memory
+struct AvnRecord {
+    const char* data;
+    uint32_t length;
+    uint64_t offset;      // logical position, can be passed back to replay from here
+    uint64_t publish_ns;
+};
+
+inline uint64_t avn_record_size(uint32_t length) {
+    return (sizeof(AvnRecordHeader) + length + 7) & ~uint64_t(7);
+}
+
+class AvnBus {
+public:
+    AvnBus() : header(nullptr), ring(nullptr), map_size(0) {}
+    ~AvnBus() { close_bus(); }
+
+    // Producer side: create the segment if needed and keep the existing ring if
+    // it is already valid, so a restarted generator does not wipe unread records
+    bool create() {
+        int fd = shm_open(AVN_BUS_NAME, O_CREAT | O_RDWR, 0666);
+        if (fd == -1) return false;
+        map_size = sizeof(AvnBusHeader) + AVN_BUS_CAPACITY;
+        if (ftruncate(fd, map_size) == -1) {
+            close(fd);
+            return false;
+        }
+        bool ok = map(fd);
+        close(fd);
+        if (!ok) return false;
+
+        if (header->magic != AVN_BUS_MAGIC || header->version != AVN_BUS_VERSION || header->capacity != AVN_BUS_CAPACITY) {
+            header->version = AVN_BUS_VERSION;
+            header->capacity = AVN_BUS_CAPACITY;
+            header->head.store(0);
+            header->tail.store(0);
+            std::atomic_thread_fence(std::memory_order_release);
+            header->magic = AVN_BUS_MAGIC;
+        }
+        return true;
+    }
+
+    // Consumer side: attach to a ring the generator already created
+    bool attach() {
+        int fd = shm_open(AVN_BUS_NAME, O_RDWR, 0666);
+        if (fd == -1) return false;
+        struct stat st;
+        if (fstat(fd, &st) == -1 || st.st_size < (off_t)sizeof(AvnBusHeader)) {
+            close(fd);
+            return false;
+        }
+        map_size = st.st_size;
+        bool ok = map(fd);
+        close(fd);
+        if (!ok) return false;
+        if (header->magic != AVN_BUS_MAGIC || header->version != AVN_BUS_VERSION ||
+            map_size < sizeof(AvnBusHeader) + header->capacity) {
+            close_bus();
+            return false;
+        }
+        return true;
+    }
+
+    // Append one record. Only one process may publish.
+    bool publish(const char* data, uint32_t length) {
+        const uint64_t capacity = header->capacity;
+        uint64_t size = avn_record_size(length);
+        if (size > capacity / 2) return false;
+
+        uint64_t pos = header->head.load(std::memory_order_relaxed);
+        uint64_t room = capacity - pos % capacity;
+        uint64_t pad = room < size ? room : 0;  // record would straddle the end, fill and wrap
+
+        // retire the records we are about to overwrite before touching their bytes
+        uint64_t end = pos + pad + size;
+        uint64_t tail = header->tail.load(std::memory_order_relaxed);
+        while (end - tail > capacity) {
+            const AvnRecordHeader* old = record_at(tail);
+            tail += (old->flags & AVN_RECORD_PAD) ? capacity - tail % capacity : avn_record_size(old->length);
+        }
+        header->tail.store(tail, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (pad) {
+            AvnRecordHeader* filler = record_at(pos);
+            filler->length = 0;
+            filler->flags = AVN_RECORD_PAD;
+            pos += pad;
+        }
+        AvnRecordHeader* rec = record_at(pos);
+        rec->length = length;
+        rec->flags = 0;
+        rec->publish_ns = avn_bus_now_ns();
+        memcpy(reinterpret_cast<char*>(rec) + sizeof(AvnRecordHeader), data, length);
+        header->head.store(pos + size, std::memory_order_release);
+        return true;
+    }
+
+    bool publish(const std::string& msg) { return publish(msg.data(), msg.size()); }
+
+    uint64_t head() const { return header->head.load(std::memory_order_acquire); }
+    uint64_t tail() const { return header->tail.load(std::memory_order_acquire); }
+
+    AvnRecordHeader* record_at(uint64_t offset) const {
+        return reinterpret_cast<AvnRecordHeader*>(ring + offset % header->capacity);
+    }
+
+    uint64_t capacity() const { return header->capacity; }
+
+private:
+    bool map(int fd) {
+        void* p = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return false;
+        header = static_cast<AvnBusHeader*>(p);
+        ring = static_cast<char*>(p) + sizeof(AvnBusHeader);
+        return true;
+    }
+
+    void close_bus() {
+        if (header) munmap(header, map_size);
+        header = nullptr;
+        ring = nullptr;
+    }
+
+    AvnBusHeader* header;
+    char* ring;
+    size_t map_size;
+};
+
+// Per consumer cursor. Records are read in place, so check intact() after
+// using one: if it returns false the producer lapped us mid-read and the
+// record should be dropped.
+class AvnBusReader {
+public:
+    enum Start { FROM_OLDEST, FROM_NOW };
+
+    AvnBusReader(const AvnBus& bus, Start start) : bus(bus), lost_bytes(0) {
+        cursor = (start == FROM_OLDEST) ? bus.tail() : bus.head();
+    }
+
+    // Replay from a saved offset, clamped to what is still in the ring
+    AvnBusReader(const AvnBus& bus, uint64_t offset) : bus(bus), cursor(offset), lost_bytes(0) {
+        uint64_t tail = bus.tail();
+        uint64_t head = bus.head();
+        if (cursor < tail) cursor = tail;
+        if (cursor > head) cursor = head;
+    }
+
+    bool next(AvnRecord& rec) {
+        while (true) {
+            uint64_t head = bus.head();
+            uint64_t tail = bus.tail();
+            if (cursor < tail) {  // producer overwrote what we had not read yet
+                lost_bytes += tail - cursor;
+                cursor = tail;
+            }
+            if (cursor >= head) return false;
+
+            const AvnRecordHeader* h = bus.record_at(cursor);
+            uint32_t length = h->length;
+            uint32_t flags = h->flags;
+            uint64_t publish_ns = h->publish_ns;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (bus.tail() > cursor) continue;  // header was overwritten while we read it
+
+            if (flags & AVN_RECORD_PAD) {
+                cursor += bus.capacity() - cursor % bus.capacity();
+                continue;
+            }
+            rec.data = reinterpret_cast<const char*>(h) + sizeof(AvnRecordHeader);
+            rec.length = length;
+            rec.offset = cursor;
+            rec.publish_ns = publish_ns;
+            cursor += avn_record_size(length);
+            return true;
+        }
+    }
+
+    bool intact(const AvnRecord& rec) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return bus.tail() <= rec.offset;
+    }
+
+    uint64_t position() const { return cursor; }
+    uint64_t backlog() const { return bus.head() - cursor; }  // bytes published but not read yet
+    uint64_t lost() const { return lost_bytes; }
+
+private:
+    const AvnBus& bus;
+    uint64_t cursor;
+    uint64_t lost_bytes;
+};
+
+#endif
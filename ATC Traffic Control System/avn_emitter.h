@@ -0,0 +1,376 @@
+//AABIA ALI 23I-0704
+//INSHARAH IRFAN 23I-0615
+//CS-D
+
+// Asynchronous AVN pipe from atc_controller to avn_generator.
+//
+// Radar threads used to write() each AVN line straight into the pipe while
+// holding displayMutex, so a slow or stalled generator froze every radar
+// thread and the GUI behind that lock. Now emit() only copies the line into a
+// fixed ring of slots in memory and returns. It makes no syscalls: the writer
+// thread is never signalled, it looks for work every AVN_EMIT_POLL_MS.
+//
+// The writer thread moves lines from the ring into the generator's
+// (non-blocking) stdin, each prefixed with a sequence number ("@<seq> "), and
+// keeps them until the generator acknowledges them (see avn_supervisor.h).
+// If the generator dies, everything unacknowledged is sent again to the one
+// the supervisor starts next. While the pipe is full or the generator is down
+// the ring backs up, and once the ring is full the overflow policy decides
+// what emit() does:
+//   BLOCK        wait for a free slot (the caller stalls, nothing is lost)
+//   DROP_OLDEST  overwrite the oldest line still waiting (counted in dropped)
+//   SPILL        keep accepting: new lines go to a second fixed batch of slots
+//                that the writer swaps out and appends to a spill file, and the
+//                pipe is fed from the spill file, in order, until it has caught
+//                up. emit() only waits if a whole batch fills up between two
+//                writer passes, i.e. when the disk cannot keep up
+//
+// Latency is measured from emit() to the generator acknowledging the line,
+// i.e. to the AVN being in its journal.
+
+#ifndef AVN_EMITTER_H
+#define AVN_EMITTER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include "tick_trace.h"
+#include "avn_supervisor.h"
+
+const size_t AVN_EMIT_SLOTS = 256;     // lines the ring holds before the overflow policy applies
+const size_t AVN_LINE_MAX = 192;       // longest line kept, longer ones are cut (still '\n' terminated)
+const int AVN_EMIT_POLL_MS = 2;        // writer's look for new lines / pipe space interval
+const size_t AVN_SPILL_SLOTS = 1024;   // SPILL: lines emit() can hand over between two writer passes
+const size_t AVN_OUTBOX_BYTES = 16 * 1024; // bytes the writer stages for the pipe at a time
+const size_t AVN_UNACKED_MAX = 4096;   // lines sent but not acknowledged before the writer stops taking more
+
+enum AvnOverflowPolicy { AVN_BLOCK, AVN_DROP_OLDEST, AVN_SPILL };
+
+inline const char* avn_policy_name(AvnOverflowPolicy policy) {
+    switch (policy) {
+        case AVN_BLOCK: return "block";
+        case AVN_DROP_OLDEST: return "drop";
+        default: return "spill";
+    }
+}
+
+struct AvnEmitterStats {
+    uint64_t emitted = 0;     // emit() calls
+    uint64_t sent = 0;        // lines acknowledged by the generator
+    uint64_t resent = 0;      // lines sent again to a restarted generator
+    uint64_t dropped = 0;     // DROP_OLDEST overwrites, and lines still waiting for a slot at close()
+    uint64_t spilled = 0;     // lines that went through the spill file
+    uint64_t blocked = 0;     // waits for a free slot (BLOCK, or SPILL a whole batch behind)
+    uint64_t truncated = 0;   // lines longer than AVN_LINE_MAX
+    uint64_t write_errors = 0;
+    size_t max_depth = 0;     // most lines waiting in the ring at once
+};
+
+class AvnEmitter {
+public:
+    ~AvnEmitter() { close(); }
+
+    // generator must already be started; from here on only the writer thread touches it
+    bool open(AvnSupervisor& generator, AvnOverflowPolicy overflow, const std::string& spill = "avn_spill.bin") {
+        child = &generator;
+        policy = overflow;
+        if (policy == AVN_SPILL) {
+            spill_path = spill;
+            spill_fd = ::open(spill.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (spill_fd == -1) return false;
+        }
+        ring.resize(AVN_EMIT_SLOTS);
+        if (policy == AVN_SPILL) {
+            this->overflow.resize(AVN_SPILL_SLOTS);
+            taken.resize(AVN_SPILL_SLOTS);
+            spill_block.reserve(AVN_SPILL_SLOTS * (sizeof(int64_t) + sizeof(uint32_t) + AVN_LINE_MAX));
+        }
+        outbox.reserve(AVN_OUTBOX_BYTES + AVN_LINE_MAX);
+        running = true;
+        writer = std::thread(&AvnEmitter::write_loop, this);
+        return true;
+    }
+
+    // Queue one line ('\n' terminated). No syscalls or allocations unless it has to wait.
+    void emit(std::string_view line) {
+        int64_t now = trace_now_us();
+        std::unique_lock<std::mutex> lock(mtx);
+        stats.emitted++;
+        if (spilling) { // SPILL: keep order, everything goes behind the spill file
+            if (overflow_count == overflow.size()) {
+                stats.blocked++;
+                space.wait(lock, [&]() { return overflow_count < overflow.size() || !running; });
+                if (overflow_count == overflow.size()) { // closing, the line is lost
+                    stats.dropped++;
+                    return;
+                }
+                spilling = true; // the writer may have caught up meanwhile, stay behind what it has
+            }
+            copy_line(overflow[overflow_count++], line, now);
+            stats.spilled++;
+            return;
+        }
+        if (count == ring.size()) {
+            if (policy == AVN_BLOCK) {
+                stats.blocked++;
+                space.wait(lock, [&]() { return count < ring.size() || !running; });
+                if (count == ring.size()) { // closing, the line is lost
+                    stats.dropped++;
+                    return;
+                }
+            } else if (policy == AVN_DROP_OLDEST) {
+                head = (head + 1) % ring.size();
+                count--;
+                stats.dropped++;
+            } else {
+                spilling = true;
+                copy_line(overflow[overflow_count++], line, now);
+                stats.spilled++;
+                return;
+            }
+        }
+        copy_line(ring[(head + count) % ring.size()], line, now);
+        count++;
+        if (count > stats.max_depth) stats.max_depth = count;
+    }
+
+    // Send what is still waiting and wait for its acknowledgement (for at most
+    // drain_ms), then stop the writer
+    void close(int drain_ms = 2000) {
+        if (!writer.joinable()) return;
+        deadline_us = trace_now_us() + int64_t(drain_ms) * 1000;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            running = false;
+        }
+        space.notify_all();
+        writer.join();
+        if (spill_fd != -1) {
+            ::close(spill_fd);
+            spill_fd = -1;
+            unlink(spill_path.c_str());
+        }
+    }
+
+    AvnEmitterStats snapshot() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return stats;
+    }
+    const LatencyHistogram& latency() const { return latency_us; } // read after close()
+    AvnOverflowPolicy overflow_policy() const { return policy; }
+
+private:
+    struct Slot {
+        int64_t enqueued_us;
+        uint16_t length;
+        char text[AVN_LINE_MAX];
+    };
+    struct Sent {
+        uint64_t seq;
+        int64_t enqueued_us;
+        std::string text;
+    };
+
+    void write_loop() {
+        while (true) {
+            // acknowledgements first: a child that just died may have sent its last ones
+            acknowledge(child->read_acks());
+            bool up = child->check();
+            if (up && child->generation() != generation) resend();
+
+            bool closing;
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                closing = !running;
+                // ring lines are older than anything spilled, so they go straight to the outbox
+                while (up && count > 0 && has_room()) {
+                    const Slot& slot = ring[head];
+                    stage(slot.text, slot.length, slot.enqueued_us);
+                    head = (head + 1) % ring.size();
+                    count--;
+                }
+                taken.swap(overflow); // same size, nothing is allocated
+                taken_count = overflow_count;
+                overflow_count = 0;
+            }
+            if (policy != AVN_DROP_OLDEST) space.notify_all();
+
+            if (taken_count > 0) append_spill();
+            taken_count = 0;
+            if (up) refill_from_spill();
+            bool pipe_full = up && !flush_outbox();
+
+            {
+                // spilling ends once the spill file and the overflow batch are both empty
+                std::lock_guard<std::mutex> lock(mtx);
+                if (spilling && spill_read == spill_write && overflow_count == 0) {
+                    spilling = false;
+                    spill_read = spill_write = 0;
+                    if (ftruncate(spill_fd, 0) != 0) stats.write_errors++;
+                }
+                bool idle = count == 0 && overflow_count == 0 && unacked.empty() && spill_read == spill_write;
+                if (closing && (idle || trace_now_us() > deadline_us)) break;
+            }
+
+            if (up) {
+                pollfd p[2] = {{child->ack_input_fd(), POLLIN, 0}, {child->input_fd(), POLLOUT, 0}};
+                poll(p, pipe_full ? 2 : 1, AVN_EMIT_POLL_MS);
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(AVN_EMIT_POLL_MS));
+            }
+        }
+    }
+
+    // caller holds mtx
+    void copy_line(Slot& slot, std::string_view line, int64_t now) {
+        size_t n = line.size();
+        if (n > AVN_LINE_MAX) {
+            n = AVN_LINE_MAX;
+            stats.truncated++;
+        }
+        memcpy(slot.text, line.data(), n);
+        if (n > 0 && slot.text[n - 1] != '\n') slot.text[n - 1] = '\n';
+        slot.length = static_cast<uint16_t>(n);
+        slot.enqueued_us = now;
+    }
+
+    bool has_room() const { return outbox.size() < AVN_OUTBOX_BYTES && unacked.size() < AVN_UNACKED_MAX; }
+
+    void stage(const char* text, size_t length, int64_t enqueued_us) {
+        unacked.push_back({++last_seq, enqueued_us, std::string(text, length)});
+        frame(unacked.back());
+    }
+
+    void frame(const Sent& line) {
+        char prefix[24];
+        int n = snprintf(prefix, sizeof(prefix), "@%llu ", (unsigned long long)line.seq);
+        outbox.append(prefix, n);
+        outbox.append(line.text);
+    }
+
+    // everything up to seq is in the generator's journal
+    void acknowledge(uint64_t seq) {
+        if (seq == 0) return;
+        int64_t now = trace_now_us();
+        uint64_t done = 0;
+        while (!unacked.empty() && unacked.front().seq <= seq) {
+            latency_us.add(now - unacked.front().enqueued_us);
+            unacked.pop_front();
+            done++;
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        stats.sent += done;
+    }
+
+    // a new generator: whatever the last one did not acknowledge goes out again, in order
+    void resend() {
+        outbox.clear();
+        written = 0;
+        for (const Sent& line : unacked) frame(line);
+        if (generation != 0 && !unacked.empty()) {
+            std::lock_guard<std::mutex> lock(mtx);
+            stats.resent += unacked.size();
+        }
+        generation = child->generation();
+    }
+
+    // spill record: <int64 enqueued_us><uint32 length><bytes>
+    void append_spill() {
+        spill_block.clear();
+        for (size_t i = 0; i < taken_count; i++) {
+            const Slot& line = taken[i];
+            uint32_t length = line.length;
+            spill_block.append(reinterpret_cast<const char*>(&line.enqueued_us), sizeof(line.enqueued_us));
+            spill_block.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            spill_block.append(line.text, length);
+        }
+        ssize_t n = pwrite(spill_fd, spill_block.data(), spill_block.size(), spill_write);
+        if (n != static_cast<ssize_t>(spill_block.size())) {
+            std::lock_guard<std::mutex> lock(mtx);
+            stats.write_errors++;
+            return;
+        }
+        spill_write += spill_block.size();
+    }
+
+    void refill_from_spill() {
+        char header[sizeof(int64_t) + sizeof(uint32_t)];
+        std::string text;
+        while (spill_read < spill_write && has_room()) {
+            if (pread(spill_fd, header, sizeof(header), spill_read) != static_cast<ssize_t>(sizeof(header))) break;
+            int64_t enqueued_us;
+            uint32_t length;
+            memcpy(&enqueued_us, header, sizeof(enqueued_us));
+            memcpy(&length, header + sizeof(enqueued_us), sizeof(length));
+            text.resize(length);
+            if (pread(spill_fd, &text[0], length, spill_read + sizeof(header)) != static_cast<ssize_t>(length)) break;
+            stage(text.data(), length, enqueued_us);
+            spill_read += sizeof(header) + length;
+        }
+    }
+
+    // Returns false if the pipe could not take everything
+    bool flush_outbox() {
+        while (written < outbox.size()) {
+            ssize_t n = write(child->input_fd(), outbox.data() + written, outbox.size() - written);
+            if (n == -1 && errno == EINTR) continue;
+            if (n == -1 && errno == EAGAIN) return false;
+            if (n <= 0) {
+                // the generator closed its stdin; the lines stay unacknowledged and
+                // go to the next generator once the supervisor has replaced this one
+                std::lock_guard<std::mutex> lock(mtx);
+                stats.write_errors++;
+                child->replace();
+                return false;
+            }
+            written += n;
+        }
+        outbox.clear();
+        written = 0;
+        return true;
+    }
+
+    AvnSupervisor* child = nullptr;
+    AvnOverflowPolicy policy = AVN_SPILL;
+    std::thread writer;
+    mutable std::mutex mtx;
+    std::condition_variable space; // BLOCK: a slot was freed, SPILL: the writer took the overflow batch
+
+    // guarded by mtx
+    std::vector<Slot> ring;
+    size_t head = 0, count = 0;
+    std::vector<Slot> overflow;    // SPILL: lines for the spill file, AVN_SPILL_SLOTS long
+    size_t overflow_count = 0;
+    bool spilling = false;
+    bool running = false;
+    AvnEmitterStats stats;
+
+    // writer thread only
+    std::string outbox;        // bytes on their way into the pipe
+    size_t written = 0;        // outbox bytes already in the pipe
+    std::deque<Sent> unacked;  // staged or sent, not yet in the generator's journal
+    uint64_t last_seq = 0;
+    uint64_t generation = 0;   // supervisor generation the outbox was written for
+    std::string spill_path;
+    int spill_fd = -1;
+    uint64_t spill_read = 0, spill_write = 0;
+    std::vector<Slot> taken;       // the last overflow batch, swapped out under mtx
+    size_t taken_count = 0;
+    std::string spill_block;       // taken, framed for one pwrite
+    LatencyHistogram latency_us;
+    std::atomic<int64_t> deadline_us{0};
+};
+
+#endif
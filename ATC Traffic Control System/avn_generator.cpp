@@ -12,6 +12,19 @@
 #include <unistd.h>
 #include <sys/stat.h>
 #include <fstream>
+#include <algorithm>
+#include <sys/select.h>
+#include <charconv>
+#include <thread>
+#include <vector>
+#include <cstdarg>
+#include <cstdio>
+#include <cctype>
+#include "avn_bus.h"
+#include "fifo_reader.h"
+#include "avn_journal.h"
+#include "spsc_queue.h"
+#include "tick_trace.h"
 
 using namespace std;
 
@@ -31,26 +44,37 @@ struct AVN {
     std::string due_date;         // 3 days from issuance
 };
 
-// Generate unique AVN ID
+// Generate unique AVN ID (at least 3 digits, grows past AVN999)
 std::string generate_avn_id(int count) {
-    return "AVN" + std::string(3 - std::to_string(count).length(), '0') + std::to_string(count);
+    std::string digits = std::to_string(count);
+    return "AVN" + std::string(digits.length() < 3 ? 3 - digits.length() : 0, '0') + digits;
 }
 
-// Get current time as string
-std::string get_current_time() {
-    std::time_t now = std::time(nullptr);
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S");
-    return ss.str();
-}
+// Issue and due dates, formatted once per second rather than once per AVN
+struct IssueClock {
+    std::time_t second = -1;
+    char issued[32] = "";   // YYYY-MM-DD HH:MM:SS
+    char due[16] = "";      // YYYY-MM-DD, 3 days from issuance
+
+    void refresh() {
+        std::time_t now = std::time(nullptr);
+        if (now == second) return;
+        second = now;
+        std::tm local;
+        localtime_r(&now, &local);
+        strftime(issued, sizeof(issued), "%Y-%m-%d %H:%M:%S", &local);
+        std::time_t due_time = now + 3 * 24 * 60 * 60; // Add 3 days
+        localtime_r(&due_time, &local);
+        strftime(due, sizeof(due), "%Y-%m-%d", &local);
+    }
+};
 
-// Get due date (3 days from now)
-std::string get_due_date() {
-    std::time_t now = std::time(nullptr);
-    now += 3 * 24 * 60 * 60; // Add 3 days
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&now), "%Y-%m-%d");
-    return ss.str();
+// Value of "Key=" in a comma separated message
+std::string parse_field(const std::string& msg, const std::string& key) {
+    size_t start = msg.find(key);
+    if (start == std::string::npos) return "";
+    start += key.size();
+    return msg.substr(start, msg.find(',', start) - start);
 }
 
 // Calculate fine amount
@@ -59,9 +83,307 @@ double calculate_fine(const std::string& aircraft_type) {
     return base_fine * 1.15; // Add 15% service fee
 }
 
+// One violation or payment on its way through the pipeline
+struct AvnWork {
+    enum Kind { VIOLATION, PAYMENT, END } kind = END;
+    int64_t received_us = 0;
+    uint64_t ack_seq = 0;        // controller's sequence number, 0 without --ack-fd
+    std::string line;            // input line / payment confirmation
+    std::string error;           // set when the line is rejected, printed by fan-out
+    std::string note;            // nothing to publish, just say so on stdout
+    AVN avn;
+    std::string avn_msg;         // bus message, with '\n'
+    std::string log_msg;         // AVNlog.txt entry
+    uint64_t journal_seq = 0;
+};
+
+// Violations go parse -> enrich -> persist -> fan-out, one thread per stage,
+// joined by SPSC queues. Payments travel the same queues so they stay in
+// order with the AVNs they pay for.
+//   parse    split the line, validate type and numbers
+//   enrich   AVN ID, fine, issue/due dates, bus and log messages (the only
+//            stage that numbers AVNs, so IDs stay in input order)
+//   persist  journal append and AVNlog.txt, payment lookups; does not wait
+//            for the disk, the journal's group commit runs while it carries on
+//   fan-out  waits until the AVN is durable, then publishes it on the bus,
+//            prints it and acknowledges it to the controller
+class AvnPipeline {
+public:
+    static const size_t QUEUE_SLOTS = 1024;
+
+    AvnPipeline(AvnJournal& journal, AvnBus& bus, std::ofstream& log, int ack_fd, int first_avn)
+        : journal(journal), bus(bus), log(log), ack_fd(ack_fd), avn_count(first_avn),
+          parse_in(QUEUE_SLOTS), enrich_in(QUEUE_SLOTS), persist_in(QUEUE_SLOTS), fanout_in(QUEUE_SLOTS) {}
+
+    void start() {
+        stages.emplace_back(&AvnPipeline::parse_stage, this);
+        stages.emplace_back(&AvnPipeline::enrich_stage, this);
+        stages.emplace_back(&AvnPipeline::persist_stage, this);
+        stages.emplace_back(&AvnPipeline::fanout_stage, this);
+    }
+
+    // From the reading thread only
+    void submit(AvnWork::Kind kind, std::string_view line) {
+        AvnWork work;
+        work.kind = kind;
+        work.received_us = trace_now_us();
+        if (kind == AvnWork::VIOLATION && line.size() > 1 && line[0] == '@') {
+            size_t space = line.find(' ');
+            if (space == std::string_view::npos) space = line.size();
+            std::from_chars(line.data() + 1, line.data() + space, work.ack_seq);
+            line.remove_prefix(std::min(space + 1, line.size()));
+        }
+        work.line.assign(line);
+        parse_in.push(std::move(work));
+    }
+
+    // Let everything submitted so far through, then stop the stages
+    void finish() {
+        AvnWork end;
+        parse_in.push(std::move(end));
+        for (std::thread& stage : stages) stage.join();
+        stages.clear();
+    }
+
+    void report() const {
+        double span = (last_out_us - first_in_us) / 1e6;
+        std::cout << "[AVN Generator] Pipeline: " << issued << " AVNs, " << payments << " payments, " << rejected
+                  << " rejected";
+        if (issued > 0 && span > 0) {
+            std::cout << "; " << std::fixed << std::setprecision(1) << issued / span << " AVNs/s sustained over "
+                      << std::setprecision(3) << span << " s";
+        }
+        std::cout << "; in to published p50 " << latency.percentile(50) << " us, p99 " << latency.percentile(99)
+                  << " us" << std::endl;
+        std::cout << "[AVN Generator] Stage busy (ms): parse " << busy_us[0] / 1000 << ", enrich " << busy_us[1] / 1000
+                  << ", persist " << busy_us[2] / 1000 << ", fan-out " << busy_us[3] / 1000
+                  << "; deepest queue " << std::max({parse_in.max_depth(), enrich_in.max_depth(),
+                                                     persist_in.max_depth(), fanout_in.max_depth()})
+                  << " of " << QUEUE_SLOTS << std::endl;
+    }
+
+private:
+    void parse_stage() {
+        AvnWork work;
+        while (true) {
+            parse_in.pop(work);
+            int64_t started = trace_now_us();
+            if (work.kind == AvnWork::VIOLATION) parse(work);
+            busy_us[0] += trace_now_us() - started;
+            bool end = work.kind == AvnWork::END;
+            enrich_in.push(std::move(work));
+            if (end) return;
+        }
+    }
+
+    // Parse input (e.g., "PIA001 PIA 0 650 HOLDING 200 600")
+    static void parse(AvnWork& work) {
+        const std::string& line = work.line;
+        std::string_view fields[8];
+        size_t count = 0, pos = 0;
+        while (count < 8) {
+            while (pos < line.size() && isspace(static_cast<unsigned char>(line[pos]))) pos++;
+            if (pos == line.size()) break;
+            size_t start = pos;
+            while (pos < line.size() && !isspace(static_cast<unsigned char>(line[pos]))) pos++;
+            fields[count++] = std::string_view(line).substr(start, pos - start);
+        }
+        double speed = 0, permissiblemin = 0, permissiblemax = 0;
+        bool valid = count == 7 && to_double(fields[3], speed) && to_double(fields[5], permissiblemin) &&
+                     to_double(fields[6], permissiblemax);
+        if (!valid) { // missing, malformed or extra fields
+            work.error = "[AVN Generator] Invalid input: " + line;
+            return;
+        }
+
+        // Validate type
+        std::string_view type_str = fields[2];
+        AVN& avn = work.avn;
+        if (type_str == "0") avn.aircraft_type = "Commercial";
+        else if (type_str == "1") avn.aircraft_type = "Cargo";
+        else if (type_str == "2") avn.aircraft_type = "Emergency";
+        else {
+            work.error = "[AVN Generator] Invalid aircraft type: " + std::string(type_str);
+            return;
+        }
+        avn.flight_number.assign(fields[0]);
+        avn.airline_name.assign(fields[1]);
+        avn.speed_recorded = speed;
+        avn.speed_permissibleMIN = permissiblemin;
+        avn.speed_permissibleMAX = permissiblemax;
+    }
+
+    static bool to_double(std::string_view field, double& value) {
+        auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+        return result.ec == std::errc() && result.ptr == field.data() + field.size();
+    }
+
+    void enrich_stage() {
+        AvnWork work;
+        while (true) {
+            enrich_in.pop(work);
+            int64_t started = trace_now_us();
+            if (work.kind == AvnWork::VIOLATION && work.error.empty()) enrich(work);
+            busy_us[1] += trace_now_us() - started;
+            bool end = work.kind == AvnWork::END;
+            persist_in.push(std::move(work));
+            if (end) return;
+        }
+    }
+
+    void enrich(AvnWork& work) {
+        clock.refresh();
+        AVN& avn = work.avn;
+        avn.avn_id = generate_avn_id(avn_count++);
+        avn.issuance_time = clock.issued;
+        avn.fine_amount = calculate_fine(avn.aircraft_type);
+        avn.payment_status = "unpaid";
+        avn.due_date = clock.due;
+
+        // ye wala is for sending through pipes again (with the \n for the bus)
+        format(work.avn_msg, "AVN_ID=%s,Flight=%s,Airline=%s,Type=%s,Speed=%f/%f - %f,Issued=%s,Fine=%f,Status=%s,Due=%s\n",
+               avn.avn_id.c_str(), avn.flight_number.c_str(), avn.airline_name.c_str(), avn.aircraft_type.c_str(),
+               avn.speed_recorded, avn.speed_permissibleMIN, avn.speed_permissibleMAX, avn.issuance_time.c_str(),
+               avn.fine_amount, avn.payment_status.c_str(), avn.due_date.c_str());
+        // ye log files ke liye hai, just cuz it's easier to read
+        format(work.log_msg, "AVN_ID = %s\nFlight = %s\nAirline = %s\nType = %s\nSpeed = %f\nPermissible range = %f - %f\n"
+               "Issued = %s\nFine = %f\nStatus = %s\nDue = %s\n\n",
+               avn.avn_id.c_str(), avn.flight_number.c_str(), avn.airline_name.c_str(), avn.aircraft_type.c_str(),
+               avn.speed_recorded, avn.speed_permissibleMIN, avn.speed_permissibleMAX, avn.issuance_time.c_str(),
+               avn.fine_amount, avn.payment_status.c_str(), avn.due_date.c_str());
+    }
+
+    static void format(std::string& out, const char* fmt, ...) {
+        va_list args, again;
+        va_start(args, fmt);
+        va_copy(again, args);
+        out.resize(256);
+        int n = vsnprintf(&out[0], out.size() + 1, fmt, args);
+        if (n > 256) {
+            out.resize(n);
+            vsnprintf(&out[0], out.size() + 1, fmt, again);
+        }
+        out.resize(n < 0 ? 0 : n);
+        va_end(again);
+        va_end(args);
+    }
+
+    void persist_stage() {
+        AvnWork work;
+        while (true) {
+            persist_in.pop(work);
+            int64_t started = trace_now_us();
+            if (work.kind == AvnWork::VIOLATION && work.error.empty()) {
+                // maps an AVN to a flight id
+                avn_map[work.avn.flight_number] = work.avn;
+                log << work.log_msg;
+                std::string message(work.avn_msg, 0, work.avn_msg.size() - 1);
+                work.journal_seq = journal.issue(work.avn.avn_id, message);
+            } else if (work.kind == AvnWork::PAYMENT) {
+                persist_payment(work);
+            }
+            if (persist_in.empty()) log.flush(); // once per burst rather than once per AVN
+            busy_us[2] += trace_now_us() - started;
+            bool end = work.kind == AvnWork::END;
+            fanout_in.push(std::move(work));
+            if (end) return;
+        }
+    }
+
+    // AVN=AVN123,Flight=PK123,Status=paid
+    void persist_payment(AvnWork& work) {
+        const std::string& confirmation = work.line;
+        size_t avn_pos = confirmation.find("AVN=");
+        size_t status_pos = confirmation.find("Status=paid");
+        if (avn_pos == std::string::npos || status_pos == std::string::npos) {
+            work.error = "[AVN Generator] Invalid payment message: " + confirmation;
+            return;
+        }
+        std::string avn_id = confirmation.substr(avn_pos + 4, confirmation.find(',', avn_pos) - (avn_pos + 4));
+        uint64_t seq = journal.mark_paid(avn_id);
+        if (seq == 0) {
+            work.note = "[AVN Generator] No unpaid AVN " + avn_id + " to mark paid";
+            return;
+        }
+        work.journal_seq = seq;
+        std::string flight_id = parse_field(journal.find(avn_id)->message, "Flight=");
+        auto flight = avn_map.find(flight_id);
+        if (flight != avn_map.end() && flight->second.avn_id == avn_id) flight->second.payment_status = "paid";
+        work.avn.avn_id = avn_id;
+        work.avn.flight_number = flight_id;
+        work.avn_msg = "AVN=" + avn_id + ",Flight=" + flight_id + ",Status=paid\n";
+    }
+
+    void fanout_stage() {
+        AvnWork work;
+        uint64_t durable = 0, to_ack = 0;
+        while (true) {
+            fanout_in.pop(work);
+            if (work.kind == AvnWork::END) break;
+            int64_t started = trace_now_us();
+            // Nothing goes out before the journal has it
+            if (work.journal_seq > durable) {
+                journal.wait_durable(work.journal_seq);
+                durable = work.journal_seq;
+            }
+            if (!work.error.empty()) {
+                std::cerr << work.error << std::endl;
+                if (work.kind == AvnWork::VIOLATION) rejected++;
+            } else if (!work.note.empty()) {
+                std::cout << work.note << std::endl;
+            } else if (work.kind == AvnWork::VIOLATION) {
+                // Publish to the AVN bus for Airline Portal and StripePay
+                if (bus.publish(work.avn_msg)) std::cout << "[AVN Generator] Published: " << work.avn_msg;
+                else std::cout << "[AVN Generator] AVN too large for bus, logged: " << work.avn_msg;
+                issued++;
+            } else {
+                // Notify Airline Portal and StripePay of the payment
+                std::cout << "[AVN Generator] Updated " << work.avn.avn_id << " (" << work.avn.flight_number << ") to paid" << std::endl;
+                if (bus.publish(work.avn_msg)) std::cout << "[AVN Generator] Notified Portal: " << work.avn_msg;
+                payments++;
+            }
+            if (work.ack_seq) to_ack = work.ack_seq;
+            int64_t now = trace_now_us();
+            if (first_in_us == 0) first_in_us = work.received_us;
+            last_out_us = now;
+            latency.add(now - work.received_us);
+            // one acknowledgement per burst, it covers everything up to to_ack
+            if (ack_fd != -1 && to_ack && fanout_in.empty()) {
+                write_all(ack_fd, std::to_string(to_ack) + "\n");
+                to_ack = 0;
+            }
+            busy_us[3] += now - started;
+        }
+        if (ack_fd != -1 && to_ack) write_all(ack_fd, std::to_string(to_ack) + "\n");
+    }
+
+    AvnJournal& journal;
+    AvnBus& bus;
+    std::ofstream& log;
+    int ack_fd;
+    int avn_count;          // enrich stage only
+    IssueClock clock;       // enrich stage only
+    std::unordered_map<std::string, AVN> avn_map; // persist stage only
+
+    SpscQueue<AvnWork> parse_in, enrich_in, persist_in, fanout_in;
+    std::vector<std::thread> stages;
+
+    // written by one stage each, read by report() after finish()
+    int64_t busy_us[4] = {};
+    uint64_t issued = 0, payments = 0, rejected = 0;
+    int64_t first_in_us = 0, last_out_us = 0;
+    LatencyHistogram latency;
+};
+
 
-int main() {
+int main(int argc, char* argv[]) {
 
+    // --ack-fd N: atc_controller's supervisor reads acknowledgements on this fd. Input lines
+    // then start with "@<seq> ", and "<seq>\n" goes back once everything up to seq is journaled
+    int ack_fd = -1;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--ack-fd") ack_fd = atoi(argv[i + 1]);
+    }
 
     ofstream logFile;
     logFile.open("AVNlog.txt", ios::app | ios::out); // changed  to append as well
@@ -70,26 +392,43 @@ int main() {
             exit(1); // Exit if log file can't be opened
         }
 
+    // Recover issued/paid state from the journal; AVN IDs carry on from the last run
+    AvnJournal journal;
+    if (!journal.open()) {
+        std::cerr << "[AVN Generator] Failed to open AVN journal" << std::endl;
+        return 1;
+    }
+    JournalStats recovered = journal.stats();
+    std::cout << "[AVN Generator] Recovered " << journal.avns().size() << " AVNs (" << recovered.snapshot_avns
+              << " from snapshot, " << recovered.replayed << " journal records";
+    if (recovered.torn_bytes) std::cout << ", cut " << recovered.torn_bytes << " torn bytes";
+    std::cout << ") in " << recovered.recovery_ms << " ms" << std::endl;
 
-    std::unordered_map<std::string, AVN> avn_map;
-
-    
-    int avn_count = 1;
+    int avn_count = journal.highest_avn_number() + 1;
 
-    // Create FIFOs
+    // Create FIFOs (portal_fifo carries StripePay confirmations to the portal)
     const char* portal_fifo = "portal_fifo";
-    const char* stripe_fifo = "stripe_fifo";
     const char* payment_fifo = "payment_fifo";
     mkfifo(portal_fifo, 0666);
-    mkfifo(stripe_fifo, 0666);
     mkfifo(payment_fifo, 0666);
 
-    // Open payment FIFO for reading confirmations
+    // AVNs go out once on the shared memory bus, portal and StripePay each read it at their own pace
+    AvnBus bus;
+    if (!bus.create()) {
+        std::cerr << "[AVN Generator] Failed to create AVN bus " << AVN_BUS_NAME << std::endl;
+        return 1;
+    }
+
+    // Open payment FIFO for reading confirmations from StripePay
     int payment_fd = open(payment_fifo, O_RDONLY | O_NONBLOCK);
     if (payment_fd == -1) {
         std::cerr << "Failed to open payment FIFO" << std::endl;
         return 1;
     }
+    // hold a write end ourselves so the FIFO doesn't report EOF while StripePay isn't running
+    int payment_keepalive_fd = open(payment_fifo, O_WRONLY | O_NONBLOCK);
+    FramedReader payment_reader;
+    std::vector<std::string_view> confirmations;
 
     // Read flight data from terminal
     /*
@@ -99,137 +438,45 @@ int main() {
     std::cout << "Press Enter twice or Ctrl+D to finish:\n";
     */
     
-   // Read flight data from stdin (piped from ATC)
-    std::string line;
-    while (std::getline(std::cin, line)) {
-        if (line.empty()) {
-            std::cerr << "[AVN Generator] Empty input, skipping" << std::endl;
-            continue;
-        }
-        
-        // Parse input (e.g., "PIA001 PIA 0 650 HOLDING 200 600")
-        std::stringstream ss(line);
-        std::string flight_id, airline, type_str, phase;
-        double speed, permissiblemin, permissiblemax;
-        bool valid = true;
-
-        // Read space-separated fields
-        if (!(ss >> flight_id)) valid = false;
-        if (!(ss >> airline)) valid = false;
-        if (!(ss >> type_str)) valid = false;
-        if (!(ss >> speed)) valid = false;
-        if (!(ss >> phase)) valid = false;
-        if (!(ss >> permissiblemin)) valid = false;
-        if (!(ss >> permissiblemax)) valid = false;
-
-        if (!valid || !ss.eof()) { // Check for extra fields
-            std::cerr << "[AVN Generator] Invalid input: " << line << std::endl;
-            continue;
-        }
-
-        // Validate type
-        std::string aircraft_type;
-        if (type_str == "0") aircraft_type = "Commercial";
-        else if (type_str == "1") aircraft_type = "Cargo";
-        else if (type_str == "2") aircraft_type = "Emergency";
-        else {
-            std::cerr << "[AVN Generator] Invalid aircraft type: " << type_str << std::endl;
-            continue;
-        }
-
-        // Generate AVN
-        AVN avn;
-        avn.avn_id = generate_avn_id(avn_count++);
-        avn.airline_name = airline;
-        avn.flight_number = flight_id;
-        avn.aircraft_type = aircraft_type;
-        avn.speed_recorded = speed;
-        avn.speed_permissibleMIN = permissiblemin;
-        avn.speed_permissibleMAX = permissiblemax;
-        avn.issuance_time = get_current_time();
-        avn.fine_amount = calculate_fine(aircraft_type);
-        avn.payment_status = "unpaid";
-        avn.due_date = get_due_date();
-
-        // Store in hashmap
-        // maps an AVN to a flight id
-        avn_map[flight_id] = avn;
-
-        // Prepare AVN message
-        
-        // ye wala is for sending through pipes again, \n nahi hai is main
-        string avn_msg = "AVN_ID=" + avn.avn_id + ",Flight=" + avn.flight_number +
-                             ",Airline=" + avn.airline_name + ",Type=" + avn.aircraft_type +
-                             ",Speed=" + std::to_string(avn.speed_recorded) + "/" +
-                             std::to_string(avn.speed_permissibleMIN) + " - " +  std::to_string(avn.speed_permissibleMAX)  + ",Issued=" + avn.issuance_time +
-                             ",Fine=" + std::to_string(avn.fine_amount) + ",Status=" + avn.payment_status +
-                             ",Due=" + avn.due_date + "\n";
-                   
-        // ye log files ke liye hai, just cuz it's easier to read   
-        string log_msg = "AVN_ID = " + avn.avn_id + "\n" + "Flight = " + avn.flight_number + "\n" +
-                             "Airline = " + avn.airline_name + "\n" + "Type = " + avn.aircraft_type + "\n"+
-                             "Speed = " + std::to_string(avn.speed_recorded) + "\n"  + "Permissible range = " +
-                             std::to_string(avn.speed_permissibleMIN) + " - " +  std::to_string(avn.speed_permissibleMAX) + "\n" + "Issued = " + avn.issuance_time +"\n"  				+ "Fine = " + std::to_string(avn.fine_amount) + "\n"+ "Status = " + avn.payment_status + "\n" +
-                             "Due = " + avn.due_date + "\n";
-                             
-                                     logFile << log_msg << endl;
-
-        // Send to Airline Portal FIFO
-        int portal_fd = open(portal_fifo, O_WRONLY | O_NONBLOCK);
-        if (portal_fd != -1) {
-            write(portal_fd, avn_msg.c_str(), avn_msg.size());
-            close(portal_fd);
-            std::cout << "[AVN Generator] Sent to Portal: " << avn_msg;
-        } else {
-            std::cout << "[AVN Generator] Portal FIFO not available, logged: " << avn_msg;
+   // Read flight data from stdin (piped from ATC), and payments as they come rather than only between violations.
+   // This thread only reads; the pipeline stages do the rest.
+    AvnPipeline pipeline(journal, bus, logFile, ack_fd, avn_count);
+    pipeline.start();
+    FramedReader input_reader;
+    std::vector<std::string_view> input_lines;
+    bool input_open = true;
+    while (input_open) {
+        fd_set read_fds;
+        FD_ZERO(&read_fds);
+        FD_SET(STDIN_FILENO, &read_fds);
+        FD_SET(payment_fd, &read_fds);
+        if (select(std::max(STDIN_FILENO, payment_fd) + 1, &read_fds, nullptr, nullptr, nullptr) == -1) {
+            if (errno == EINTR) continue;
+            break;
         }
 
-        // Send to StripePay FIFO
-        int stripe_fd = open(stripe_fifo, O_WRONLY | O_NONBLOCK);
-        if (stripe_fd != -1) {
-            write(stripe_fd, avn_msg.c_str(), avn_msg.size());
-            close(stripe_fd);
-            std::cout << "[AVN Generator] Sent to StripePay: " << avn_msg;
-        } else {
-            std::cout << "[AVN Generator] StripePay FIFO not available, logged: " << avn_msg;
+        if (FD_ISSET(STDIN_FILENO, &read_fds)) {
+            if (input_reader.read_once(STDIN_FILENO, input_lines) <= 0) input_open = false;
+            for (std::string_view input_line : input_lines) pipeline.submit(AvnWork::VIOLATION, input_line);
         }
 
-        // Check for payment confirmations
-        // Flight=123,Status=paid
-        char buffer[256];
-        ssize_t n = read(payment_fd, buffer, sizeof(buffer) - 1);
-        if (n > 0) {
-            buffer[n] = '\0';
-            std::string confirmation = buffer;
-            size_t flight_pos = confirmation.find("Flight=");
-            if (flight_pos != std::string::npos) {
-                size_t status_pos = confirmation.find(",Status=");
-                if (status_pos != std::string::npos) {
-                    std::string flight_id = confirmation.substr(7, status_pos - 7);
-                    if (avn_map.find(flight_id) != avn_map.end()) {
-                        avn_map[flight_id].payment_status = "paid";
-                        std::cout << "[AVN Generator] Updated " << flight_id << " to paid" << std::endl;
-
-                        // Notify Airline Portal
-                        std::string update_msg = "Flight=" + flight_id + ",Status=paid\n";
-                        portal_fd = open(portal_fifo, O_WRONLY | O_NONBLOCK);
-                        if (portal_fd != -1) {
-                            write(portal_fd, update_msg.c_str(), update_msg.size());
-                            close(portal_fd);
-                            std::cout << "[AVN Generator] Notified Portal: " << update_msg;
-                        }
-
-                    }
-                }
-            }
-        }
+        // Check for payment confirmations, each one a full line even if they arrived together
+        payment_reader.read_from(payment_fd, confirmations);
+        for (std::string_view record : confirmations) pipeline.submit(AvnWork::PAYMENT, record);
     }
+    pipeline.finish();
+    pipeline.report();
 
     // Cleanup
+    journal.close();
+    JournalStats totals = journal.stats();
+    std::cout << "[AVN Generator] Journal: " << totals.appended << " records in " << totals.commits
+              << " commits, " << totals.snapshots << " snapshots" << std::endl;
     close(payment_fd);
+    if (payment_keepalive_fd != -1) close(payment_keepalive_fd);
     unlink(portal_fifo);
-    unlink(stripe_fifo);
     unlink(payment_fifo);
+    // the bus is left in /dev/shm so late readers can still replay it
 
 
 
@@ -0,0 +1,364 @@
+//AABIA ALI 23I-0704
+//INSHARAH IRFAN 23I-0615
+//CS-D
+
+// Write-ahead journal for AVN state: every AVN issued and every payment is
+// appended to avn_journal.wal before anyone else hears about it, so a restart
+// knows exactly which fines exist and which were paid.
+//
+// avn_journal.wal   one record per line: <seq> <I|P> <crc32> <payload>
+//                   I = issued, payload is the AVN bus message
+//                   P = paid, payload is the AVN ID
+// avn_journal.snap  compacted state up to some seq: a header line, then
+//                   one "<0|1> <AVN message>" line per AVN (1 = paid)
+//
+// Appends only go to memory. A flusher thread writes everything appended since
+// its last pass with one write() and one fdatasync() (group commit), and every
+// COMPACT_EVERY records it writes a fresh snapshot and empties the WAL, so
+// recovery reads the snapshot plus a short tail. A torn last record from a
+// crash fails its checksum and is cut off.
+//
+// Only avn_generator writes the journal; the portal opens it read only.
+
+#ifndef AVN_JOURNAL_H
+#define AVN_JOURNAL_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include "fifo_reader.h"
+
+const int JOURNAL_COMMIT_INTERVAL_MS = 10;       // longest an append waits to become durable
+const size_t JOURNAL_GROUP_BYTES = 64 * 1024;    // flush early once this much is waiting
+const uint64_t JOURNAL_COMPACT_EVERY = 10000;    // WAL records between snapshots
+
+inline uint32_t journal_crc32(const std::string& data) {
+    static const std::array<uint32_t, 256> table = []() {
+        std::array<uint32_t, 256> t;
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (unsigned char ch : data) crc = table[(crc ^ ch) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+struct JournalAvn {
+    std::string avn_id;
+    std::string message;  // AVN bus message as issued, without '\n'
+    bool paid = false;
+};
+
+struct JournalStats {
+    uint64_t snapshot_avns = 0;     // AVNs read from the snapshot at startup
+    uint64_t replayed = 0;          // WAL records applied at startup
+    uint64_t torn_bytes = 0;        // bytes cut from the end of the WAL at startup
+    uint64_t appended = 0;
+    uint64_t commits = 0;           // fdatasync calls, one per group
+    uint64_t snapshots = 0;
+    double recovery_ms = 0.0;
+};
+
+// AVNs by ID in issue order. The journal keeps one for lookups and the
+// flusher keeps a second one, updated from each committed batch, to render
+// snapshots from without holding the journal lock.
+struct JournalState {
+    std::vector<JournalAvn> records;
+    std::unordered_map<std::string, size_t> by_id;
+
+    void issue(const std::string& avn_id, const std::string& message) {
+        auto it = by_id.find(avn_id);
+        if (it != by_id.end()) {  // same ID again, keep the newer AVN
+            records[it->second].message = message;
+            records[it->second].paid = false;
+        } else {
+            by_id[avn_id] = records.size();
+            records.push_back({avn_id, message, false});
+        }
+    }
+
+    bool paid(const std::string& avn_id) {
+        auto it = by_id.find(avn_id);
+        if (it == by_id.end() || records[it->second].paid) return false;
+        records[it->second].paid = true;
+        return true;
+    }
+
+    std::string render(uint64_t seq) const {
+        std::string out = "AVNSNAP " + std::to_string(seq) + " " + std::to_string(records.size()) + "\n";
+        for (const JournalAvn& avn : records) {
+            out += avn.paid ? "1 " : "0 ";
+            out += avn.message + "\n";
+        }
+        return out;
+    }
+};
+
+class AvnJournal {
+public:
+    explicit AvnJournal(const std::string& base = "avn_journal")
+        : wal_path(base + ".wal"), snap_path(base + ".snap") {}
+
+    ~AvnJournal() { close(); }
+
+    // Writer: recover, then keep the WAL open and start the flusher
+    bool open() {
+        if (!recover(true)) return false;
+        wal_fd = ::open(wal_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0666);
+        if (wal_fd == -1) return false;
+        image = state;
+        stopping = false;
+        flusher = std::thread(&AvnJournal::flush_loop, this);
+        return true;
+    }
+
+    // Reader: recover state without touching the files
+    bool load() { return recover(false); }
+
+    // Record a new AVN; returns its sequence number for wait_durable()
+    uint64_t issue(const std::string& avn_id, const std::string& message) {
+        std::lock_guard<std::mutex> lock(mtx);
+        apply_issue(avn_id, message);
+        changes.push_back({'I', avn_id, message});
+        return append('I', message);
+    }
+
+    // Record a payment; 0 if the AVN is unknown or already paid
+    uint64_t mark_paid(const std::string& avn_id) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!apply_paid(avn_id)) return 0;
+        changes.push_back({'P', avn_id, std::string()});
+        return append('P', avn_id);
+    }
+
+    // Block until everything up to seq is on disk
+    void wait_durable(uint64_t seq) {
+        std::unique_lock<std::mutex> lock(mtx);
+        flush_cv.notify_one();
+        durable_cv.wait(lock, [&]() { return durable_seq >= seq || failed || wal_fd == -1; });
+    }
+
+    // Flush what is left and stop the flusher
+    void close() {
+        if (!flusher.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        flush_cv.notify_one();
+        flusher.join();
+        ::close(wal_fd);
+        wal_fd = -1;
+    }
+
+    // Recovered/current AVNs in issue order. Only safe to read from the
+    // thread that appends, or after load().
+    const std::vector<JournalAvn>& avns() const { return state.records; }
+
+    const JournalAvn* find(const std::string& avn_id) const {
+        auto it = state.by_id.find(avn_id);
+        return it == state.by_id.end() ? nullptr : &state.records[it->second];
+    }
+
+    // Highest N among the AVNnnn IDs seen, so IDs keep counting across restarts
+    int highest_avn_number() const { return highest_number; }
+
+    JournalStats stats() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return counters;
+    }
+
+private:
+    struct Change {
+        char type;            // 'I' or 'P', as in the WAL
+        std::string avn_id;
+        std::string message;  // issued AVNs only
+    };
+
+    uint64_t append(char type, const std::string& payload) {
+        uint64_t seq = next_seq++;
+        std::string prefix = std::to_string(seq) + " " + type;
+        pending += prefix + " " + hex_crc(prefix + " " + payload) + " " + payload + "\n";
+        counters.appended++;
+        since_snapshot++;
+        if (pending.size() >= JOURNAL_GROUP_BYTES) flush_cv.notify_one();
+        return seq;
+    }
+
+    void apply_issue(const std::string& avn_id, const std::string& message) {
+        state.issue(avn_id, message);
+        if (avn_id.size() > 3 && avn_id.compare(0, 3, "AVN") == 0) {
+            int number = atoi(avn_id.c_str() + 3);
+            if (number > highest_number) highest_number = number;
+        }
+    }
+
+    bool apply_paid(const std::string& avn_id) { return state.paid(avn_id); }
+
+    static std::string id_of(const std::string& message) {
+        size_t start = message.find("AVN_ID=");
+        if (start == std::string::npos) return "";
+        start += 7;
+        return message.substr(start, message.find(',', start) - start);
+    }
+
+    bool recover(bool writer) {
+        auto started = std::chrono::steady_clock::now();
+        uint64_t snapshot_seq = 0;
+
+        // Snapshot first
+        std::ifstream snap(snap_path);
+        if (snap.is_open()) {
+            std::string line, magic;
+            uint64_t count = 0;
+            std::getline(snap, line);
+            std::istringstream header(line);
+            header >> magic >> snapshot_seq >> count;
+            if (magic != "AVNSNAP") return false;
+            while (std::getline(snap, line)) {
+                if (line.size() < 3) continue;
+                std::string message = line.substr(2);
+                apply_issue(id_of(message), message);
+                if (line[0] == '1') apply_paid(id_of(message));
+            }
+            counters.snapshot_avns = state.records.size();
+            if (state.records.size() != count) {
+                fprintf(stderr, "[Journal] Snapshot lists %llu AVNs but holds %zu\n",
+                        (unsigned long long)count, state.records.size());
+            }
+        }
+        next_seq = snapshot_seq + 1;
+
+        // Then the WAL records written after it, stopping at the first bad one
+        std::ifstream wal(wal_path, std::ios::binary);
+        uint64_t good_bytes = 0, total_bytes = 0;
+        if (wal.is_open()) {
+            std::string line;
+            while (std::getline(wal, line)) {
+                if (wal.eof()) break;  // no '\n', the write never finished
+                size_t s1 = line.find(' ');
+                size_t s2 = s1 == std::string::npos ? s1 : line.find(' ', s1 + 1);
+                size_t s3 = s2 == std::string::npos ? s2 : line.find(' ', s2 + 1);
+                if (s3 == std::string::npos || s2 != s1 + 2) break;
+                std::string payload = line.substr(s3 + 1);
+                std::string body = line.substr(0, s2) + " " + payload;
+                if (line.substr(s2 + 1, s3 - s2 - 1) != hex_crc(body)) break;
+
+                uint64_t seq = std::stoull(line.substr(0, s1));
+                if (seq > snapshot_seq) {
+                    if (line[s1 + 1] == 'I') apply_issue(id_of(payload), payload);
+                    else apply_paid(payload);
+                    counters.replayed++;
+                    since_snapshot++;
+                }
+                if (seq >= next_seq) next_seq = seq + 1;
+                good_bytes += line.size() + 1;
+            }
+            wal.clear();
+            wal.seekg(0, std::ios::end);
+            total_bytes = static_cast<uint64_t>(wal.tellg());
+        }
+        if (total_bytes > good_bytes) {
+            counters.torn_bytes = total_bytes - good_bytes;
+            if (writer && truncate(wal_path.c_str(), good_bytes) == -1) return false;
+        }
+        durable_seq = next_seq - 1;
+        counters.recovery_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        return true;
+    }
+
+    static std::string hex_crc(const std::string& body) {
+        char crc[9];
+        snprintf(crc, sizeof(crc), "%08x", journal_crc32(body));
+        return crc;
+    }
+
+    // Write to a temp file, sync it, then rename over the old snapshot
+    bool write_snapshot(const std::string& contents) {
+        std::string tmp = snap_path + ".tmp";
+        int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if (fd == -1) return false;
+        bool ok = write_all(fd, contents) && fsync(fd) == 0;
+        ::close(fd);
+        if (!ok || rename(tmp.c_str(), snap_path.c_str()) == -1) return false;
+        int dir_fd = ::open(".", O_RDONLY);
+        if (dir_fd != -1) {
+            fsync(dir_fd);
+            ::close(dir_fd);
+        }
+        return true;
+    }
+
+    void flush_loop() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true) {
+            flush_cv.wait_for(lock, std::chrono::milliseconds(JOURNAL_COMMIT_INTERVAL_MS),
+                              [&]() { return stopping || pending.size() >= JOURNAL_GROUP_BYTES; });
+            if (pending.empty()) {
+                if (stopping) break;
+                continue;
+            }
+            std::string batch;
+            batch.swap(pending);
+            std::vector<Change> batch_changes;
+            batch_changes.swap(changes);
+            uint64_t batch_seq = next_seq - 1;
+            bool snapshot_due = since_snapshot >= JOURNAL_COMPACT_EVERY;
+            if (snapshot_due) since_snapshot = 0;
+            lock.unlock();
+
+            // Bring the flusher's copy of the state up to this batch. The snapshot
+            // is rendered from it with the lock released, so appends carry on
+            // meanwhile; they stay in `pending`, so emptying the WAL loses nothing.
+            for (const Change& change : batch_changes) {
+                if (change.type == 'I') image.issue(change.avn_id, change.message);
+                else image.paid(change.avn_id);
+            }
+            bool ok = write_all(wal_fd, batch) && fdatasync(wal_fd) == 0;
+            bool compacted = ok && snapshot_due && write_snapshot(image.render(batch_seq)) && ftruncate(wal_fd, 0) == 0;
+            if (!ok) fprintf(stderr, "[Journal] Failed to write %s\n", wal_path.c_str());
+
+            lock.lock();
+            counters.commits++;
+            if (compacted) counters.snapshots++;
+            if (ok) durable_seq = batch_seq;
+            else failed = true;  // don't leave callers waiting on a disk that refuses writes
+            durable_cv.notify_all();
+        }
+    }
+
+    std::string wal_path, snap_path;
+    int wal_fd = -1;
+    JournalState state;           // guarded by mtx
+    JournalState image;           // flusher only, matches what has been written
+    int highest_number = 0;
+
+    std::mutex mtx;
+    std::condition_variable flush_cv, durable_cv;
+    std::thread flusher;
+    bool stopping = false;
+    bool failed = false;
+    std::string pending;          // appended but not yet written
+    std::vector<Change> changes;  // the same records, for `image`
+    uint64_t next_seq = 1;
+    uint64_t durable_seq = 0;
+    uint64_t since_snapshot = 0;
+    JournalStats counters;
+};
+
+#endif
@@ -0,0 +1,195 @@
+//AABIA ALI 23I-0704
+//INSHARAH IRFAN 23I-0615
+//CS-D
+
+// Keeps atc_controller's avn_generator child running.
+//
+// The generator is started with two pipes: AVN lines go to its stdin, and it
+// writes an acknowledgement ("<seq>\n", cumulative) to fd 3 once the AVNs up
+// to that sequence number are in its journal. AvnEmitter keeps every line
+// until it is acknowledged and resends the rest to a restarted generator, so
+// a crash loses nothing (a line journaled just before a crash but not yet
+// acknowledged is issued twice).
+//
+// check() reaps the child with waitpid(WNOHANG) and, once its backoff has
+// passed, starts a new one. The backoff doubles from AVN_RESTART_MIN_MS up to
+// AVN_RESTART_MAX_MS on every crash and resets once a child has stayed up for
+// AVN_STABLE_MS. Nothing here blocks: only the emitter's writer thread calls
+// check(), and the counters can be read from any thread.
+//
+// SIGPIPE is ignored, so writing to a dead generator fails with EPIPE instead
+// of killing the controller.
+
+#ifndef AVN_SUPERVISOR_H
+#define AVN_SUPERVISOR_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <csignal>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "fifo_reader.h"
+#include "tick_trace.h"
+
+const int AVN_ACK_FD = 3;                 // the child's fd for acknowledgements
+const int64_t AVN_RESTART_MIN_MS = 100;
+const int64_t AVN_RESTART_MAX_MS = 5000;
+const int64_t AVN_STABLE_MS = 10000;      // uptime after which a crash starts the backoff over
+
+class AvnSupervisor {
+public:
+    ~AvnSupervisor() { stop(); }
+
+    bool start(const char* program = "./avn_generator") {
+        path = program;
+        signal(SIGPIPE, SIG_IGN);
+        return spawn();
+    }
+
+    // Reap a dead child and restart it when its backoff is over; true while a child is running
+    bool check() {
+        int64_t now = trace_now_us();
+        if (pid > 0) {
+            int status;
+            pid_t done = waitpid(pid, &status, WNOHANG);
+            if (done == 0 || (done == -1 && errno == EINTR)) return true;
+            int64_t lived = now - started_us;
+            up_us += lived;
+            last_status = status;
+            pid = -1;
+            running = false;
+            close_fds();
+            backoff_ms = lived >= AVN_STABLE_MS * 1000 ? AVN_RESTART_MIN_MS
+                                                       : std::min(backoff_ms * 2, AVN_RESTART_MAX_MS);
+            restart_at = now + backoff_ms * 1000;
+            return false;
+        }
+        if (stopping || now < restart_at) return false;
+        restarts++;
+        return spawn();
+    }
+
+    // The child stopped reading its stdin but did not exit: replace it
+    void replace() {
+        if (pid > 0) kill(pid, SIGTERM);
+    }
+
+    // Highest sequence number acknowledged since the last call, 0 if none
+    uint64_t read_acks() {
+        if (ack_fd == -1) return 0;
+        acks.read_from(ack_fd, ack_lines);
+        uint64_t highest = 0;
+        for (std::string_view line : ack_lines) {
+            uint64_t seq = 0;
+            std::from_chars(line.data(), line.data() + line.size(), seq);
+            if (seq > highest) highest = seq;
+        }
+        return highest;
+    }
+
+    // Close the child's stdin so it finishes, wait up to timeout_ms for it to exit
+    void stop(int timeout_ms = 3000) {
+        stopping = true;
+        if (data_fd != -1) {
+            ::close(data_fd);
+            data_fd = -1;
+        }
+        if (pid > 0) {
+            int64_t deadline = trace_now_us() + int64_t(timeout_ms) * 1000;
+            int status;
+            while (waitpid(pid, &status, WNOHANG) == 0) {
+                if (trace_now_us() > deadline) {
+                    kill(pid, SIGTERM);
+                    waitpid(pid, &status, 0);
+                    break;
+                }
+                usleep(10000);
+            }
+            up_us += trace_now_us() - started_us;
+            pid = -1;
+            running = false;
+        }
+        close_fds();
+    }
+
+    int input_fd() const { return data_fd; }
+    int ack_input_fd() const { return ack_fd; }
+    uint64_t generation() const { return spawned; } // changes on every (re)start
+
+    bool up() const { return running; }
+    long restart_count() const { return restarts; }
+    int exit_status() const { return last_status; }
+    // seconds the current child has been running (0 while down)
+    long uptime_seconds() const { return running ? long((trace_now_us() - started_us) / 1000000) : 0; }
+    long total_up_seconds() const { return long((up_us + (running ? trace_now_us() - started_us : 0)) / 1000000); }
+
+private:
+    bool spawn() {
+        int data[2], ack[2];
+        if (pipe2(data, O_CLOEXEC) == -1) return false;
+        if (pipe2(ack, O_CLOEXEC) == -1) {
+            ::close(data[0]);
+            ::close(data[1]);
+            return false;
+        }
+        pid_t child = fork();
+        if (child == 0) {
+            // only async-signal-safe calls between fork and exec, the parent has threads
+            if (dup2(data[0], STDIN_FILENO) == -1 || dup2(ack[1], AVN_ACK_FD) == -1) _exit(127);
+            if (ack[1] == AVN_ACK_FD) fcntl(AVN_ACK_FD, F_SETFD, 0);
+            execl(path, path, "--ack-fd", "3", (char*)NULL);
+            const char msg[] = "[AVN Generator] execl failed\n";
+            if (write(STDERR_FILENO, msg, sizeof(msg) - 1)) {}
+            _exit(127);
+        }
+        ::close(data[0]);
+        ::close(ack[1]);
+        if (child < 0) {
+            ::close(data[1]);
+            ::close(ack[0]);
+            restart_at = trace_now_us() + backoff_ms * 1000;
+            return false;
+        }
+        fcntl(data[1], F_SETFL, fcntl(data[1], F_GETFL) | O_NONBLOCK);
+        fcntl(ack[0], F_SETFL, fcntl(ack[0], F_GETFL) | O_NONBLOCK);
+        data_fd = data[1];
+        ack_fd = ack[0];
+        acks = FramedReader();
+        pid = child;
+        started_us = trace_now_us();
+        spawned++;
+        running = true;
+        return true;
+    }
+
+    void close_fds() {
+        if (data_fd != -1) ::close(data_fd);
+        if (ack_fd != -1) ::close(ack_fd);
+        data_fd = ack_fd = -1;
+    }
+
+    const char* path = "./avn_generator";
+    pid_t pid = -1;
+    int data_fd = -1, ack_fd = -1;
+    FramedReader acks;
+    std::vector<std::string_view> ack_lines;
+    int64_t backoff_ms = AVN_RESTART_MIN_MS;
+    int64_t restart_at = 0;
+    bool stopping = false;
+    uint64_t spawned = 0;
+
+    // read by the status views
+    std::atomic<bool> running{false};
+    std::atomic<long> restarts{0};
+    std::atomic<int> last_status{0};
+    std::atomic<int64_t> started_us{0};
+    std::atomic<int64_t> up_us{0};
+};
+
+#endif
@@ -0,0 +1,108 @@
+//AABIA ALI 23I-0704
+//INSHARAH IRFAN 23I-0615
+//CS-D
+
+// Query the columnar event file written by atc_controller (see event_store.h).
+//
+//   ./event_query [file] [--flight ID] [--runway NAME|N|none] [--kind KIND]
+//                 [--from SEC] [--to SEC] [--limit N] [--count]
+//
+// file defaults to events.evc, times are seconds since the run started,
+// KIND is one of phase, dispatch, release, wait, fuel, fault, avn.
+// --count only prints how many events matched, per kind.
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include "event_store.h"
+
+using namespace std;
+
+void usage() {
+    cerr << "Usage: ./event_query [file] [--flight ID] [--runway NAME|N|none] [--kind KIND]"
+            " [--from SEC] [--to SEC] [--limit N] [--count]" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    string path = "events.evc";
+    string runway_arg;
+    EventFilter filter;
+    long limit = -1;
+    bool count_only = false;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--count") count_only = true;
+        else if (arg == "--flight" && has_value) filter.flight = argv[++i];
+        else if (arg == "--runway" && has_value) runway_arg = argv[++i];
+        else if (arg == "--from" && has_value) filter.from_ms = static_cast<int64_t>(atof(argv[++i]) * 1000);
+        else if (arg == "--to" && has_value) filter.to_ms = static_cast<int64_t>(atof(argv[++i]) * 1000);
+        else if (arg == "--limit" && has_value) limit = atol(argv[++i]);
+        else if (arg == "--kind" && has_value) {
+            string kind = argv[++i];
+            for (int k = 0; k < EV_KIND_COUNT; k++) {
+                if (kind == event_kind_name(k)) filter.kind = k;
+            }
+            if (filter.kind == -1) {
+                cerr << "[Event Query] Unknown kind: " << kind << endl;
+                return 1;
+            }
+        } else if (arg[0] != '-') path = arg;
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    EventFile file;
+    if (!file.open(path)) {
+        cerr << "[Event Query] Failed to open event file " << path << endl;
+        return 1;
+    }
+
+    // runway by name (as in runways.cfg), by id, or "none"
+    if (!runway_arg.empty()) {
+        if (runway_arg == "none") filter.runway = -1;
+        for (size_t r = 0; r < file.runway_names.size(); r++) {
+            if (file.runway_names[r] == runway_arg) filter.runway = static_cast<int>(r);
+        }
+        if (filter.runway == -2) {
+            if (runway_arg.find_first_not_of("0123456789") != string::npos) {
+                cerr << "[Event Query] Unknown runway: " << runway_arg << endl;
+                return 1;
+            }
+            filter.runway = atoi(runway_arg.c_str());
+        }
+    }
+
+    long matched = 0;
+    long per_kind[EV_KIND_COUNT] = {};
+    auto started = chrono::steady_clock::now();
+    bool ok = file.scan(filter, [&](const Event& ev) {
+        matched++;
+        if (ev.kind < EV_KIND_COUNT) per_kind[ev.kind]++;
+        if (count_only || (limit >= 0 && matched > limit)) return;
+        cout << fixed << setprecision(3) << setw(10) << ev.time_ms / 1000.0 << "  "
+             << left << setw(9) << event_kind_name(ev.kind) << setw(10) << ev.flight
+             << setw(8) << file.runway_name(ev.runway) << setw(14) << file.phase_name(ev.phase)
+             << right << ev.value << endl;
+    });
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+
+    if (count_only) {
+        for (int k = 0; k < EV_KIND_COUNT; k++) {
+            if (per_kind[k]) cout << left << setw(10) << event_kind_name(k) << right << per_kind[k] << endl;
+        }
+    }
+    cout << "[Event Query] " << matched << " events matched, " << file.blocks_total << " blocks ("
+         << file.blocks_skipped << " skipped), " << file.size << " bytes, "
+         << fixed << setprecision(2) << ms << " ms" << endl;
+    if (!ok) {
+        cerr << "[Event Query] File is damaged after the events shown" << endl;
+        return 1;
+    }
+    return 0;
+}
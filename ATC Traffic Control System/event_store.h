@@ -0,0 +1,455 @@
+//AABIA ALI 23I-0704
+//INSHARAH IRFAN 23I-0615
+//CS-D
+
+// Columnar event file for offline analysis of a simulation run (events.evc).
+//
+// atc_controller records typed events (phase changes, runway dispatch/release,
+// waits, fuel and fault emergencies, AVNs) next to the free text in log.txt.
+// Events are buffered and written by a background thread in blocks of about
+// EVENT_BLOCK_ROWS (more when the disk falls behind), and each block stores
+// every field as its own column with an encoding that suits it:
+//
+//   time     ms since the run started, delta + zigzag varint
+//   kind     run length encoded
+//   flight   index into the block's flight dictionary, varint
+//   runway   run length encoded (runway id + 1, 0 = none)
+//   phase    run length encoded
+//   value    zigzag varint (wait seconds, fuel %, speed ...)
+//
+// File layout:
+//   header   "ATEV" magic, version, run start (unix ms), runway names, phase names
+//   blocks   "EBLK", row count, min/max time, flight dictionary, column sizes, columns
+//
+// EventFile maps the file and scans it; blocks whose time range or flight
+// dictionary cannot match a filter are skipped without decoding.
+
+#ifndef EVENT_STORE_H
+#define EVENT_STORE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <deque>
+#include <string_view>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "fifo_reader.h"
+
+const uint32_t EVENT_FILE_MAGIC = 0x56455441;   // "ATEV"
+const uint32_t EVENT_BLOCK_MAGIC = 0x4B4C4245;  // "EBLK"
+const uint16_t EVENT_FILE_VERSION = 1;
+const size_t EVENT_BLOCK_ROWS = 16384;
+const int EVENT_COLUMNS = 6;
+
+enum EventKind : uint8_t { EV_PHASE, EV_DISPATCH, EV_RELEASE, EV_WAIT, EV_FUEL, EV_FAULT, EV_AVN, EV_KIND_COUNT };
+
+inline const char* event_kind_name(int kind) {
+    static const char* names[] = {"phase", "dispatch", "release", "wait", "fuel", "fault", "avn"};
+    return (kind >= 0 && kind < EV_KIND_COUNT) ? names[kind] : "?";
+}
+
+struct Event {
+    int64_t time_ms;     // since the run started
+    uint8_t kind;
+    std::string flight;
+    int8_t runway;       // -1 = none
+    uint8_t phase;
+    int32_t value;
+};
+
+// --- encoding helpers ---
+
+inline void put_varint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out += static_cast<char>((v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    out += static_cast<char>(v);
+}
+
+inline bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t byte = *p++;
+        v |= uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+inline uint64_t zigzag(int64_t v) { return (uint64_t(v) << 1) ^ uint64_t(v >> 63); }
+inline int64_t unzigzag(uint64_t v) { return int64_t(v >> 1) ^ -int64_t(v & 1); }
+
+inline void put_rle(std::string& out, const std::vector<uint8_t>& values) {
+    for (size_t i = 0; i < values.size();) {
+        size_t run = 1;
+        while (i + run < values.size() && values[i + run] == values[i]) run++;
+        out += static_cast<char>(values[i]);
+        put_varint(out, run);
+        i += run;
+    }
+}
+
+inline bool get_rle(const uint8_t* p, const uint8_t* end, size_t count, std::vector<uint8_t>& values) {
+    values.clear();
+    while (values.size() < count && p < end) {
+        uint8_t value = *p++;
+        uint64_t run;
+        if (!get_varint(p, end, run) || values.size() + run > count) return false;
+        values.insert(values.end(), run, value);
+    }
+    return values.size() == count;
+}
+
+template <typename T>
+inline void put_raw(std::string& out, T v) { out.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+
+template <typename T>
+inline bool get_raw(const uint8_t*& p, const uint8_t* end, T& v) {
+    if (end - p < static_cast<ptrdiff_t>(sizeof(v))) return false;
+    memcpy(&v, p, sizeof(v));
+    p += sizeof(v);
+    return true;
+}
+
+inline void put_name(std::string& out, const std::string& name) {
+    out += static_cast<char>(name.size() < 255 ? name.size() : 255);
+    out.append(name, 0, 255);
+}
+
+inline bool get_name(const uint8_t*& p, const uint8_t* end, std::string& name) {
+    if (p >= end || end - p < 1 + *p) return false;
+    name.assign(reinterpret_cast<const char*>(p + 1), *p);
+    p += 1 + *p;
+    return true;
+}
+
+// --- writer ---
+
+// record() only appends to in-memory columns. A full block is swapped with the
+// writer thread's empty one and encoded and written there, so the threads that
+// record events (the tick loop, runway controllers, radar threads holding
+// displayMutex) never wait for the disk. If the writer is still busy with the
+// last block, record() keeps filling and hands over a bigger block next time.
+class EventSink {
+public:
+    ~EventSink() { close(); }
+
+    bool open(const std::string& path, const std::vector<std::string>& runway_names,
+              const std::vector<std::string>& phase_names) {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if (fd == -1) return false;
+        start = std::chrono::steady_clock::now();
+        int64_t start_unix_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        std::string header;
+        put_raw(header, EVENT_FILE_MAGIC);
+        put_raw(header, EVENT_FILE_VERSION);
+        put_raw(header, start_unix_ms);
+        put_raw(header, static_cast<uint16_t>(runway_names.size()));
+        for (const std::string& name : runway_names) put_name(header, name);
+        put_raw(header, static_cast<uint16_t>(phase_names.size()));
+        for (const std::string& name : phase_names) put_name(header, name);
+        bytes = header.size();
+
+        // full blocks are the steady state, so size both sets of columns for one up front
+        filling.reserve(EVENT_BLOCK_ROWS);
+        sealed.reserve(EVENT_BLOCK_ROWS);
+        if (!write_all(fd, header)) {
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        writer = std::thread(&EventSink::write_loop, this);
+        return true;
+    }
+
+    void record(EventKind kind, std::string_view flight, int runway, int phase, int32_t value) {
+        int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        std::lock_guard<std::mutex> lock(mtx);
+        if (fd == -1 || stopping) return;
+        filling.add(now_ms, kind, flight, runway, phase, value);
+        total++;
+        if (filling.times.size() >= EVENT_BLOCK_ROWS && !sealed_ready) {
+            filling.swap(sealed); // sealed is empty while the writer is idle
+            sealed_ready = true;
+            work.notify_one();
+        }
+    }
+
+    // Write out everything recorded so far and close the file
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (fd == -1 || stopping) return;
+            stopping = true;
+        }
+        work.notify_one();
+        writer.join();
+        write_block(filling); // nothing records any more, this thread owns the rest
+        ::close(fd);
+        fd = -1;
+    }
+
+    uint64_t events() const { return total; }
+    uint64_t bytes_written() const { return bytes; } // read after close()
+
+private:
+    struct Columns {
+        std::vector<int64_t> times;
+        std::vector<uint8_t> kinds, runways, phases;
+        std::vector<uint32_t> flights;
+        std::vector<int32_t> values;
+        std::deque<std::string> dict;  // deque so the views in dict_index stay put
+        std::unordered_map<std::string_view, uint32_t> dict_index;
+
+        void add(int64_t time_ms, EventKind kind, std::string_view flight, int runway, int phase, int32_t value) {
+            auto it = dict_index.find(flight);
+            if (it == dict_index.end()) {
+                dict.emplace_back(flight);
+                it = dict_index.emplace(dict.back(), static_cast<uint32_t>(dict.size() - 1)).first;
+            }
+            times.push_back(time_ms);
+            kinds.push_back(kind);
+            flights.push_back(it->second);
+            runways.push_back(static_cast<uint8_t>(runway + 1));
+            phases.push_back(static_cast<uint8_t>(phase));
+            values.push_back(value);
+        }
+
+        void reserve(size_t rows) {
+            times.reserve(rows);
+            kinds.reserve(rows);
+            flights.reserve(rows);
+            runways.reserve(rows);
+            phases.reserve(rows);
+            values.reserve(rows);
+        }
+
+        void clear() {
+            times.clear(); kinds.clear(); flights.clear(); runways.clear(); phases.clear(); values.clear();
+            dict_index.clear();
+            dict.clear();
+        }
+
+        // swapping keeps every dict string where it is, so dict_index stays valid
+        void swap(Columns& other) {
+            times.swap(other.times);
+            kinds.swap(other.kinds);
+            runways.swap(other.runways);
+            phases.swap(other.phases);
+            flights.swap(other.flights);
+            values.swap(other.values);
+            dict.swap(other.dict);
+            dict_index.swap(other.dict_index);
+        }
+    };
+
+    void write_loop() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true) {
+            work.wait(lock, [&]() { return sealed_ready || stopping; });
+            if (!sealed_ready) return; // stopping, close() writes what is left
+            lock.unlock();
+            write_block(sealed);
+            lock.lock();
+            sealed_ready = false;
+        }
+    }
+
+    // writer thread, or close() once the writer has stopped
+    void write_block(Columns& c) {
+        if (c.times.empty()) return;
+        std::string cols[EVENT_COLUMNS];
+        int64_t prev = 0, min_t = c.times[0], max_t = c.times[0];
+        for (int64_t t : c.times) {
+            put_varint(cols[0], zigzag(t - prev));
+            prev = t;
+            if (t < min_t) min_t = t;
+            if (t > max_t) max_t = t;
+        }
+        put_rle(cols[1], c.kinds);
+        for (uint32_t f : c.flights) put_varint(cols[2], f);
+        put_rle(cols[3], c.runways);
+        put_rle(cols[4], c.phases);
+        for (int32_t v : c.values) put_varint(cols[5], zigzag(v));
+
+        std::string block;
+        put_raw(block, EVENT_BLOCK_MAGIC);
+        put_raw(block, static_cast<uint32_t>(c.times.size()));
+        put_raw(block, min_t);
+        put_raw(block, max_t);
+        put_raw(block, static_cast<uint32_t>(c.dict.size()));
+        for (const std::string& name : c.dict) put_name(block, name);
+        for (const std::string& col : cols) put_raw(block, static_cast<uint32_t>(col.size()));
+        for (const std::string& col : cols) block += col;
+        write_all(fd, block);
+        bytes += block.size();
+
+        // each block carries its own dictionary, so it can be decoded on its own
+        c.clear();
+    }
+
+    int fd = -1;
+    std::chrono::steady_clock::time_point start;
+    std::mutex mtx;
+    std::condition_variable work;  // a block was sealed, or close() wants the writer to stop
+    std::thread writer;
+    Columns filling;               // record() appends here (guarded by mtx)
+    Columns sealed;                // the writer's block while sealed_ready, empty otherwise
+    bool sealed_ready = false;     // guarded by mtx
+    bool stopping = false;         // guarded by mtx
+    uint64_t total = 0;
+    uint64_t bytes = 0;            // writer thread, then close()
+};
+
+// --- reader ---
+
+struct EventFilter {
+    std::string flight;         // empty = any
+    int runway = -2;            // -2 = any, -1 = none
+    int kind = -1;              // -1 = any
+    int64_t from_ms = INT64_MIN;
+    int64_t to_ms = INT64_MAX;
+};
+
+class EventFile {
+public:
+    ~EventFile() {
+        if (data) munmap(const_cast<uint8_t*>(data), size);
+    }
+
+    bool open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1) return false;
+        struct stat st;
+        if (fstat(fd, &st) == -1 || st.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        size = st.st_size;
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        data = static_cast<const uint8_t*>(p);
+        madvise(p, size, MADV_SEQUENTIAL);
+
+        const uint8_t* cur = data;
+        const uint8_t* end = data + size;
+        uint32_t magic;
+        uint16_t version, count;
+        if (!get_raw(cur, end, magic) || magic != EVENT_FILE_MAGIC) return false;
+        if (!get_raw(cur, end, version) || version != EVENT_FILE_VERSION) return false;
+        if (!get_raw(cur, end, start_unix_ms)) return false;
+        if (!get_raw(cur, end, count)) return false;
+        runway_names.resize(count);
+        for (std::string& name : runway_names) if (!get_name(cur, end, name)) return false;
+        if (!get_raw(cur, end, count)) return false;
+        phase_names.resize(count);
+        for (std::string& name : phase_names) if (!get_name(cur, end, name)) return false;
+        first_block = cur;
+        return true;
+    }
+
+    // Call fn(event) for every event matching the filter, in file order.
+    // Returns false if the file is damaged (events before the damage are still delivered).
+    template <typename Fn>
+    bool scan(const EventFilter& filter, Fn fn) {
+        const uint8_t* cur = first_block;
+        const uint8_t* end = data + size;
+        Event ev;
+        std::vector<uint8_t> kinds, runways, phases;
+        std::vector<std::string> dict;
+        blocks_total = blocks_skipped = 0;
+
+        while (cur < end) {
+            uint32_t magic, rows, dict_count, col_size[EVENT_COLUMNS];
+            int64_t min_t, max_t;
+            if (!get_raw(cur, end, magic) || magic != EVENT_BLOCK_MAGIC) return false;
+            if (!get_raw(cur, end, rows) || !get_raw(cur, end, min_t) || !get_raw(cur, end, max_t)) return false;
+            if (!get_raw(cur, end, dict_count)) return false;
+            dict.resize(dict_count);
+            int64_t flight_id = -1;
+            for (uint32_t i = 0; i < dict_count; i++) {
+                if (!get_name(cur, end, dict[i])) return false;
+                if (dict[i] == filter.flight) flight_id = i;
+            }
+            size_t body = 0;
+            for (uint32_t& s : col_size) {
+                if (!get_raw(cur, end, s)) return false;
+                body += s;
+            }
+            if (static_cast<size_t>(end - cur) < body) return false;
+            const uint8_t* col[EVENT_COLUMNS];
+            for (int c = 0; c < EVENT_COLUMNS; c++) {
+                col[c] = cur;
+                cur += col_size[c];
+            }
+            blocks_total++;
+
+            // block statistics rule it out: don't decode
+            if (max_t < filter.from_ms || min_t > filter.to_ms || (!filter.flight.empty() && flight_id < 0)) {
+                blocks_skipped++;
+                continue;
+            }
+
+            if (!get_rle(col[1], col[1] + col_size[1], rows, kinds) ||
+                !get_rle(col[3], col[3] + col_size[3], rows, runways) ||
+                !get_rle(col[4], col[4] + col_size[4], rows, phases)) return false;
+            const uint8_t* tp = col[0];
+            const uint8_t* fp = col[2];
+            const uint8_t* vp = col[5];
+            int64_t t = 0;
+            for (uint32_t r = 0; r < rows; r++) {
+                uint64_t dt, f, v;
+                if (!get_varint(tp, col[1], dt) || !get_varint(fp, col[3], f) || !get_varint(vp, col[5] + col_size[5], v) ||
+                    f >= dict.size()) return false;
+                t += unzigzag(dt);
+                if (t < filter.from_ms || t > filter.to_ms) continue;
+                if (flight_id >= 0 ? static_cast<int64_t>(f) != flight_id : !filter.flight.empty()) continue;
+                int runway = static_cast<int>(runways[r]) - 1;
+                if (filter.runway != -2 && runway != filter.runway) continue;
+                if (filter.kind != -1 && kinds[r] != filter.kind) continue;
+
+                ev.time_ms = t;
+                ev.kind = kinds[r];
+                ev.flight = dict[f];
+                ev.runway = static_cast<int8_t>(runway);
+                ev.phase = phases[r];
+                ev.value = static_cast<int32_t>(unzigzag(v));
+                fn(ev);
+            }
+        }
+        return true;
+    }
+
+    std::string runway_name(int runway) const {
+        if (runway < 0) return "-";
+        return runway < static_cast<int>(runway_names.size()) ? runway_names[runway] : std::to_string(runway);
+    }
+    std::string phase_name(int phase) const {
+        return phase < static_cast<int>(phase_names.size()) ? phase_names[phase] : std::to_string(phase);
+    }
+
+    int64_t start_unix_ms = 0;
+    std::vector<std::string> runway_names;
+    std::vector<std::string> phase_names;
+    size_t size = 0;
+    size_t blocks_total = 0, blocks_skipped = 0;  // from the last scan
+
+private:
+    const uint8_t* data = nullptr;
+    const uint8_t* first_block = nullptr;
+};
+
+#endif
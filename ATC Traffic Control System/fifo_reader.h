@@ -0,0 +1,174 @@
+//AABIA ALI 23I-0704
+//INSHARAH IRFAN 23I-0615
+//CS-D
+
+// Framed reading for FIFOs and pipes.
+//
+// A single read() can return half a message or several messages glued
+// together, so readers must not treat one read() as one record. FramedReader
+// keeps a growable buffer per fd, pulls in everything currently available and
+// hands back every complete record; a partial record stays buffered until
+// the rest arrives.
+//
+// Two framings are supported:
+//   NEWLINE        records end with '\n' (what every writer in this project sends)
+//   LENGTH_PREFIX  records start with a 4 byte little endian length, for payloads that may contain '\n'
+
+#ifndef FIFO_READER_H
+#define FIFO_READER_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unistd.h>
+
+class FramedReader {
+public:
+    enum Framing { NEWLINE, LENGTH_PREFIX };
+
+    explicit FramedReader(Framing framing = NEWLINE, size_t max_record = 1 << 20)
+        : framing(framing), max_record(max_record), buffer(4096), start(0), end(0), eof(false), discarding(false), dropped(0) {}
+
+    // Read everything currently available on fd (non-blocking fds stop at EAGAIN)
+    // and append every complete record to `records`. The views point into the
+    // internal buffer and stay valid until the next call.
+    // Returns the number of bytes read, or -1 on a read error.
+    ssize_t read_from(int fd, std::vector<std::string_view>& records) {
+        records.clear();
+        compact();
+
+        ssize_t total = 0;
+        while (true) {
+            if (end == buffer.size()) buffer.resize(buffer.size() * 2);
+            ssize_t n = read(fd, buffer.data() + end, buffer.size() - end);
+            if (n > 0) {
+                end += n;
+                total += n;
+                eof = false;
+                continue;
+            }
+            if (n == 0) {
+                eof = true;  // no writer right now, FIFOs can be reopened later
+                break;
+            }
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (total == 0) return -1;
+            break;
+        }
+
+        extract(records);
+        return total;
+    }
+
+    // For blocking fds: do a single read() and return whatever records it completed
+    ssize_t read_once(int fd, std::vector<std::string_view>& records) {
+        records.clear();
+        compact();
+        if (end == buffer.size()) buffer.resize(buffer.size() * 2);
+        ssize_t n;
+        do {
+            n = read(fd, buffer.data() + end, buffer.size() - end);
+        } while (n == -1 && errno == EINTR);
+        if (n > 0) end += n;
+        eof = (n == 0);
+        extract(records);
+        return n;
+    }
+
+    bool at_eof() const { return eof; }
+    size_t buffered() const { return end - start; }  // bytes of an incomplete record still waiting
+    size_t dropped_records() const { return dropped; }
+
+private:
+    void compact() {
+        if (start == 0) return;
+        if (start < end) memmove(buffer.data(), buffer.data() + start, end - start);
+        end -= start;
+        start = 0;
+    }
+
+    void extract(std::vector<std::string_view>& records) {
+        const char* base = buffer.data();
+        while (start < end) {
+            if (framing == NEWLINE) {
+                const void* nl = memchr(base + start, '\n', end - start);
+                if (!nl) {
+                    if (end - start > max_record) {  // garbage with no terminator, don't grow forever
+                        dropped++;
+                        start = end;
+                        discarding = true;  // the rest of it is not a record either
+                    }
+                    break;
+                }
+                size_t stop = static_cast<const char*>(nl) - base;
+                if (discarding) {  // tail of an oversize record, resync after its '\n'
+                    discarding = false;
+                    start = stop + 1;
+                    continue;
+                }
+                if (stop > start) records.emplace_back(base + start, stop - start);  // skip blank lines
+                start = stop + 1;
+            } else {
+                if (end - start < sizeof(uint32_t)) break;
+                uint32_t length;
+                memcpy(&length, base + start, sizeof(length));
+                if (length > max_record) {  // lost sync, nothing after this can be trusted
+                    dropped++;
+                    start = end;
+                    break;
+                }
+                if (end - start < sizeof(uint32_t) + length) break;
+                records.emplace_back(base + start + sizeof(uint32_t), length);
+                start += sizeof(uint32_t) + length;
+            }
+        }
+        if (start == end) start = end = 0;
+    }
+
+    Framing framing;
+    size_t max_record;
+    std::vector<char> buffer;
+    size_t start, end;  // unconsumed bytes are buffer[start, end)
+    bool eof;
+    bool discarding;    // dropped an oversize record, skipping to its newline
+    size_t dropped;
+};
+
+// Frame a record for the given framing
+inline std::string frame_record(std::string_view msg, FramedReader::Framing framing) {
+    if (framing == FramedReader::NEWLINE) {
+        std::string out(msg);
+        if (out.empty() || out.back() != '\n') out += '\n';
+        return out;
+    }
+    uint32_t length = msg.size();
+    std::string out(sizeof(length), '\0');
+    memcpy(&out[0], &length, sizeof(length));
+    out.append(msg.data(), msg.size());
+    return out;
+}
+
+// write() the whole buffer, retrying short writes. Records up to PIPE_BUF
+// bytes go out in one write and so never interleave with other writers.
+inline bool write_all(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = write(fd, data, length);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        length -= n;
+    }
+    return true;
+}
+
+inline bool write_all(int fd, const std::string& data) {
+    return write_all(fd, data.data(), data.size());
+}
+
+#endif
@@ -0,0 +1,127 @@
+//AABIA ALI 23I-0704
+//INSHARAH IRFAN 23I-0615
+//CS-D
+
+// Stress check for FramedReader: a child process pushes AVN messages through a
+// FIFO in randomly sized write() calls, so records get split across reads and
+// several records land in one read, and the parent checks every one arrives
+// exactly once and in order. Runs once per framing.
+//
+//   ./fifo_stress [count]     (default 100000)
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/select.h>
+#include "fifo_reader.h"
+
+using namespace std;
+
+const char* stress_fifo = "stress_fifo";
+
+// Same layout avn_generator puts on the wire
+string make_avn_msg(int i) {
+    string id = to_string(i);
+    return "AVN_ID=AVN" + id + ",Flight=PK" + to_string(i % 500) + ",Airline=PIA,Type=Commercial,"
+           "Speed=650.000000/400.000000 - 600.000000,Issued=2025-05-01 10:00:00,"
+           "Fine=575000.000000,Status=unpaid,Due=2025-05-04";
+}
+
+void run_writer(int count, FramedReader::Framing framing) {
+    int fd = open(stress_fifo, O_WRONLY);
+    if (fd == -1) _exit(2);
+
+    // build the whole stream, then cut it at random points so record boundaries never line up with writes
+    string stream;
+    for (int i = 0; i < count; i++) stream += frame_record(make_avn_msg(i), framing);
+
+    srand(42);
+    size_t pos = 0;
+    while (pos < stream.size()) {
+        size_t chunk = 1 + rand() % 1500;
+        if (chunk > stream.size() - pos) chunk = stream.size() - pos;
+        if (!write_all(fd, stream.data() + pos, chunk)) _exit(3);
+        pos += chunk;
+    }
+    close(fd);
+    _exit(0);
+}
+
+bool run_reader(int count, FramedReader::Framing framing) {
+    int fd = open(stress_fifo, O_RDONLY | O_NONBLOCK);
+    if (fd == -1) {
+        cerr << "[Stress] Failed to open " << stress_fifo << endl;
+        return false;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) run_writer(count, framing);
+
+    auto start = chrono::steady_clock::now();
+    FramedReader reader(framing);
+    vector<string_view> records;
+    int received = 0, out_of_order = 0, corrupt = 0;
+    size_t max_batch = 0;
+    bool writer_seen = false;
+
+    while (true) {
+        fd_set read_fds;
+        FD_ZERO(&read_fds);
+        FD_SET(fd, &read_fds);
+        struct timeval timeout = {5, 0};
+        if (select(fd + 1, &read_fds, nullptr, nullptr, &timeout) <= 0) break; // stalled
+
+        ssize_t n = reader.read_from(fd, records);
+        if (n > 0) writer_seen = true;
+        if (records.size() > max_batch) max_batch = records.size();
+        for (string_view rec : records) {
+            string expected = make_avn_msg(received);
+            if (rec != expected) {
+                // find out whether it is a later record (something lost) or garbage
+                if (rec.substr(0, 10) == "AVN_ID=AVN") out_of_order++;
+                else corrupt++;
+            }
+            received++;
+        }
+        if (writer_seen && reader.at_eof()) break; // writer closed its end
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    close(fd);
+
+    bool ok = received == count && out_of_order == 0 && corrupt == 0 && reader.buffered() == 0 &&
+              WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    cout << "[Stress] " << (framing == FramedReader::NEWLINE ? "newline" : "length-prefix")
+         << " framing: sent " << count << ", received " << received
+         << ", mismatched " << out_of_order << ", corrupt " << corrupt
+         << ", leftover bytes " << reader.buffered()
+         << ", largest batch " << max_batch
+         << ", " << static_cast<long>(received / (seconds > 0 ? seconds : 1)) << " AVNs/s"
+         << (ok ? "  OK" : "  FAILED") << endl;
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+    if (count <= 0) count = 100000;
+
+    unlink(stress_fifo);
+    if (mkfifo(stress_fifo, 0666) == -1) {
+        cerr << "[Stress] Failed to create " << stress_fifo << endl;
+        return 1;
+    }
+
+    bool ok = run_reader(count, FramedReader::NEWLINE);
+    ok = run_reader(count, FramedReader::LENGTH_PREFIX) && ok;
+
+    unlink(stress_fifo);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+//AABIA ALI 23I-0704
+//INSHARAH IRFAN 23I-0615
+//CS-D
+
+// Bounded single-producer single-consumer queue, used between the stages of
+// avn_generator's pipeline.
+//
+// A ring of `capacity` slots (rounded up to a power of two) with one atomic
+// index per side, each on its own cache line: the producer only writes
+// `tail`, the consumer only writes `head`, so neither ever takes a lock.
+// Items are moved in and out.
+//
+// push() and pop() wait when the ring is full or empty: they spin briefly,
+// then sleep for a growing interval (up to SPSC_MAX_SLEEP_US), so an idle
+// stage costs next to no CPU and a busy one never makes a syscall.
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+const int SPSC_SPINS = 64;               // empty/full checks before the first sleep
+const int64_t SPSC_MAX_SLEEP_US = 1000;
+
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity = 1024) {
+        size_t size = 2;
+        while (size < capacity) size *= 2;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    bool try_push(T&& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask) return false;
+        slots[t & mask] = std::move(item);
+        tail.store(t + 1, std::memory_order_release);
+        size_t depth = t + 1 - head.load(std::memory_order_relaxed);
+        if (depth > high_water) high_water = depth; // producer side only
+        return true;
+    }
+
+    bool try_pop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(T&& item) {
+        Backoff wait;
+        while (!try_push(std::move(item))) {
+            wait.pause();
+            full_waits++;
+        }
+    }
+
+    void pop(T& item) {
+        Backoff wait;
+        while (!try_pop(item)) wait.pause();
+    }
+
+    bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+    size_t capacity() const { return mask + 1; }
+    size_t max_depth() const { return high_water; }   // read after the producer is done
+    uint64_t producer_waits() const { return full_waits; }
+
+private:
+    struct Backoff {
+        int spins = 0;
+        int64_t sleep_us = 1;
+        void pause() {
+            if (spins < SPSC_SPINS) {
+                spins++;
+                std::this_thread::yield();
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(sleep_us));
+            if (sleep_us < SPSC_MAX_SLEEP_US) sleep_us *= 2;
+        }
+    };
+
+    std::vector<T> slots;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> head{0};  // next slot to pop, written by the consumer
+    alignas(64) std::atomic<size_t> tail{0};  // next slot to push, written by the producer
+    alignas(64) size_t high_water = 0;
+    uint64_t full_waits = 0;
+};
+
+#endif
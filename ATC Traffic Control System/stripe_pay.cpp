@@ -3,6 +3,7 @@
 //CS-D
 
 #include <iostream>
+#include <charconv>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -11,6 +12,21 @@
 #include <sys/stat.h>
 #include <sys/select.h>
 #include <errno.h>
+#include <climits>
+#include <string_view>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <csignal>
+#include <list>
+#include <unordered_map>
+#include <iomanip>
+#include "avn_bus.h"
+#include "fifo_reader.h"
 
 // Structure to store AVN data
 struct AVN {
@@ -23,47 +39,360 @@ struct AVN {
     double fine_amount;
     std::string payment_status;
     std::string due_date;
+    bool in_flight = false; // StripePay only: handed to the payment pipeline, waiting for the gateway
 };
 
-int main() {
-    std::vector<AVN> pending_avns;
+// Parse an AVN bus record ("AVN_ID=..,Flight=..,...") straight out of shared memory
+bool parse_avn_message(std::string_view msg, AVN& avn) {
+    size_t pos = 0;
+    while (pos < msg.length()) {
+        size_t next_pos = msg.find(',', pos);
+        if (next_pos == std::string_view::npos) next_pos = msg.length();
+        std::string_view token = msg.substr(pos, next_pos - pos);
+        pos = next_pos + 1;
 
-    // Open FIFOs in current directory
-    const char* stripe_fifo = "stripe_fifo";
-    const char* portal_fifo = "portal_fifo";
+        if (token.rfind("AVN_ID=", 0) == 0) avn.avn_id = token.substr(7);
+        else if (token.rfind("Flight=", 0) == 0) avn.flight_id = token.substr(7);
+        else if (token.rfind("Airline=", 0) == 0) avn.airline = token.substr(8);
+        else if (token.rfind("Type=", 0) == 0) avn.aircraft_type = token.substr(5);
+        else if (token.rfind("Speed=", 0) == 0) avn.speed = token.substr(6);
+        else if (token.rfind("Issued=", 0) == 0) avn.issuance_time = token.substr(7);
+        else if (token.rfind("Fine=", 0) == 0) {
+            // the record may be torn (overwritten while we read it), so a bad number is not an exception
+            std::string_view fine = token.substr(5);
+            auto result = std::from_chars(fine.data(), fine.data() + fine.size(), avn.fine_amount);
+            if (result.ec != std::errc()) return false;
+        }
+        else if (token.rfind("Status=", 0) == 0) avn.payment_status = token.substr(7);
+        else if (token.rfind("Due=", 0) == 0) avn.due_date = token.substr(4);
+    }
+    // the generator terminates each message with a newline
+    if (!avn.due_date.empty() && avn.due_date.back() == '\n') avn.due_date.pop_back();
+    if (!avn.payment_status.empty() && avn.payment_status.back() == '\n') avn.payment_status.pop_back();
+    return !avn.avn_id.empty();
+}
+
+// Where payments are actually charged. Swap in another implementation to talk
+// to a real processor; the pipeline only needs charge() to be thread safe.
+class PaymentGateway {
+public:
+    virtual ~PaymentGateway() {}
+    // Returns true if the fine was paid, filling in a receipt/reference
+    virtual bool charge(const AVN& avn, std::string& reference) = 0;
+};
+
+// Local stand-in for Stripe: takes `latency_ms` per charge like the old sleep(3) did
+class StubGateway : public PaymentGateway {
+public:
+    explicit StubGateway(int latency_ms) : latency_ms(latency_ms), next_reference(1) {}
+
+    bool charge(const AVN& avn, std::string& reference) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(latency_ms));
+        reference = "STUB" + std::to_string(next_reference++) + "-" + avn.avn_id;
+        return true;
+    }
+
+private:
+    int latency_ms;
+    std::atomic<long> next_reference;
+};
+
+struct PaymentResult {
+    AVN avn;
+    bool success;
+    std::string reference;
+};
+
+// Payment requests go into a queue and a pool of workers charges them in
+// parallel; finished payments are collected and handed back in batches, so
+// the main loop never waits on the gateway.
+class PaymentPipeline {
+public:
+    PaymentPipeline(PaymentGateway& gateway, int worker_count) : gateway(gateway), stopping(false) {
+        for (int i = 0; i < worker_count; i++) {
+            workers.emplace_back(&PaymentPipeline::work, this);
+        }
+    }
+
+    ~PaymentPipeline() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stopping = true;
+        }
+        queue_cv.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    void submit(const AVN& avn) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            requests.push_back(avn);
+        }
+        queue_cv.notify_one();
+    }
+
+    // Take every payment finished since the last call
+    std::vector<PaymentResult> collect() {
+        std::lock_guard<std::mutex> lock(results_mutex);
+        std::vector<PaymentResult> batch;
+        batch.swap(results);
+        return batch;
+    }
+
+    size_t queued() {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return requests.size();
+    }
+
+private:
+    void work() {
+        while (true) {
+            AVN avn;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_cv.wait(lock, [this]() { return stopping || !requests.empty(); });
+                if (stopping && requests.empty()) return;
+                avn = requests.front();
+                requests.pop_front();
+            }
+
+            PaymentResult result;
+            result.avn = avn;
+            result.success = gateway.charge(avn, result.reference);
+
+            std::lock_guard<std::mutex> lock(results_mutex);
+            results.push_back(result);
+        }
+    }
+
+    PaymentGateway& gateway;
+    std::vector<std::thread> workers;
+    std::deque<AVN> requests;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    bool stopping;
+    std::vector<PaymentResult> results;
+    std::mutex results_mutex;
+};
+
+// Outstanding fines keyed by AVN ID. Each fine sits on two linked lists (all
+// pending, and its airline's pending) so adding, paying and looking one up
+// are O(1) and display order stays the order fines arrived in. Per-airline
+// counts and totals are kept up to date as fines come and go.
+class PendingLedger {
+public:
+    struct AirlineView {
+        std::list<std::string> ids;
+        size_t count = 0;
+        double total = 0.0;
+    };
+
+    // false if the ID was already pending (a restarted generator reusing IDs), the newer fine replaces it
+    bool add(const AVN& avn) {
+        bool replaced = remove(avn.avn_id);
+        Entry& entry = entries[avn.avn_id];
+        entry.avn = avn;
+        entry.order_pos = order.insert(order.end(), avn.avn_id);
+        AirlineView& view = airlines[avn.airline];
+        entry.airline_pos = view.ids.insert(view.ids.end(), avn.avn_id);
+        view.count++;
+        view.total += avn.fine_amount;
+        total_amount += avn.fine_amount;
+        return !replaced;
+    }
+
+    // Paid or otherwise settled: drop it from every view
+    bool remove(const std::string& avn_id) {
+        auto it = entries.find(avn_id);
+        if (it == entries.end()) return false;
+        Entry& entry = it->second;
+        AirlineView& view = airlines[entry.avn.airline];
+        view.ids.erase(entry.airline_pos);
+        view.count--;
+        view.total -= entry.avn.fine_amount;
+        if (view.count == 0) airlines.erase(entry.avn.airline);
+        total_amount -= entry.avn.fine_amount;
+        order.erase(entry.order_pos);
+        entries.erase(it);
+        return true;
+    }
+
+    AVN* find(const std::string& avn_id) {
+        auto it = entries.find(avn_id);
+        return it == entries.end() ? nullptr : &it->second.avn;
+    }
+
+    // IDs for one page of the list, optionally only one airline's fines
+    std::vector<std::string> page(size_t page_number, size_t page_size, const std::string& airline) const {
+        const std::list<std::string>* ids = &order;
+        if (!airline.empty()) {
+            auto view = airlines.find(airline);
+            if (view == airlines.end()) return {};
+            ids = &view->second.ids;
+        }
+        std::vector<std::string> out;
+        auto it = ids->begin();
+        for (size_t skip = page_number * page_size; skip > 0 && it != ids->end(); --skip) ++it;
+        for (; it != ids->end() && out.size() < page_size; ++it) out.push_back(*it);
+        return out;
+    }
+
+    size_t size(const std::string& airline = "") const {
+        if (airline.empty()) return entries.size();
+        auto view = airlines.find(airline);
+        return view == airlines.end() ? 0 : view->second.count;
+    }
+
+    double total() const { return total_amount; }
+    const std::unordered_map<std::string, AirlineView>& airline_views() const { return airlines; }
+
+private:
+    struct Entry {
+        AVN avn;
+        std::list<std::string>::iterator order_pos;
+        std::list<std::string>::iterator airline_pos;
+    };
+
+    std::unordered_map<std::string, Entry> entries;
+    std::list<std::string> order;
+    std::unordered_map<std::string, AirlineView> airlines;
+    double total_amount = 0.0;
+};
+
+// Payment confirmations on their way to the AVN generator, which journals them.
+// The FIFO is only ever written non-blocking: lines wait here while the
+// generator is not running or not reading, and go out whole (a write of up to
+// PIPE_BUF bytes is never split) when it has room, so a slow or restarting
+// generator never stops the main loop from draining the bus.
+class PaymentLink {
+public:
+    explicit PaymentLink(const char* path) : path(path) {}
+    ~PaymentLink() { if (fd != -1) close(fd); }
 
-    // Open stripe FIFO for reading (non-blocking)
-    int stripe_fd = open(stripe_fifo, O_RDONLY | O_NONBLOCK);
-    if (stripe_fd == -1) {
-        std::cerr << "[StripePay] Failed to open stripe FIFO" << std::endl;
+    void send(const std::string& lines) {
+        pending += lines;
+        flush();
+    }
+
+    // Called every loop iteration, writes as much as the FIFO takes right now
+    void flush() {
+        while (!pending.empty()) {
+            if (fd == -1 && !reopen()) return;
+            size_t length = pending.size();
+            if (length > PIPE_BUF) {
+                size_t last = pending.rfind('\n', PIPE_BUF - 1);
+                length = (last != std::string::npos ? last : pending.find('\n')) + 1;
+            }
+            ssize_t n = write(fd, pending.data(), length);
+            if (n == -1) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN) return; // full, the generator is behind
+                // EPIPE: the generator exited, reopen once the next one is reading
+                close(fd);
+                fd = -1;
+                report_waiting();
+                return;
+            }
+            pending.erase(0, n);
+        }
+        if (waiting) {
+            std::cout << "[StripePay] AVN generator is reading again, queued payments sent" << std::endl;
+            waiting = false;
+        }
+    }
+
+    size_t queued() const { return std::count(pending.begin(), pending.end(), '\n'); }
+
+private:
+    bool reopen() {
+        fd = open(path, O_WRONLY | O_NONBLOCK); // ENXIO while nobody has it open for reading
+        if (fd == -1) report_waiting();
+        return fd != -1;
+    }
+
+    void report_waiting() {
+        if (waiting) return;
+        waiting = true;
+        std::cerr << "[StripePay] AVN generator is not reading payments, keeping them until it is" << std::endl;
+    }
+
+    const char* path;
+    int fd = -1;
+    std::string pending; // whole confirmation lines not yet written
+    bool waiting = false;
+};
+
+const size_t PAGE_SIZE = 20;
+
+int main(int argc, char* argv[]) {
+    PendingLedger ledger;
+
+    // Command line: --from <offset>, --workers <n>, --latency <ms>
+    uint64_t from_offset = 0;
+    bool from_given = false;
+    int worker_count = 4;
+    int latency_ms = 3000; // what the old blocking sleep(3) simulated
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag == "--from") { from_offset = std::stoull(argv[i + 1]); from_given = true; }
+        else if (flag == "--workers") worker_count = std::max(1, std::stoi(argv[i + 1]));
+        else if (flag == "--latency") latency_ms = std::max(0, std::stoi(argv[i + 1]));
+    }
+
+    // Attach to the AVN bus. Start from the oldest record still in the ring so
+    // fines issued before StripePay was launched are not missed (--from offset to pick another point)
+    AvnBus bus;
+    if (!bus.attach()) {
+        std::cerr << "[StripePay] Failed to attach to AVN bus (is atc_controller running?)" << std::endl;
         return 1;
     }
+    AvnBusReader reader(bus, from_given ? from_offset : bus.tail());
+
+    // Open FIFOs in current directory
+    const char* portal_fifo = "portal_fifo";
 
     // Open portal FIFO for writing
     int portal_fd = open(portal_fifo, O_WRONLY);
     if (portal_fd == -1) {
         std::cerr << "[StripePay] Failed to open portal FIFO" << std::endl;
-        close(stripe_fd);
         return 1;
     }
 
+    // Payments also go back to the AVN generator, which journals them. If it has
+    // exited, the write fails instead of killing us with SIGPIPE
+    signal(SIGPIPE, SIG_IGN);
+    PaymentLink payments("payment_fifo");
+
+    StubGateway gateway(latency_ms);
+    PaymentPipeline pipeline(gateway, worker_count);
+    std::cout << "[StripePay] Payment pipeline running with " << worker_count << " workers" << std::endl;
+
     // Set stdin to non-blocking
     int stdin_fd = fileno(stdin);
     int flags = fcntl(stdin_fd, F_GETFL, 0);
     fcntl(stdin_fd, F_SETFL, flags | O_NONBLOCK);
+    FramedReader input_reader; // one choice per line, even if several were typed/pasted at once
+    std::vector<std::string_view> input_lines;
+
+    // What the console is showing: one page of the list, maybe filtered to an airline
+    size_t page_number = 0;
+    std::string view_airline;
+    std::vector<std::string> shown_ids; // row n on screen is shown_ids[n - 1]
+    bool list_changed = true; // only redraw when something changed
+    size_t received_since_draw = 0;
+    bool running = true;
 
     // Main loop
-    while (true) {
-        // Use select to monitor stripe_fifo and stdin
+    while (running) {
+        // Use select to wait on stdin, the bus and finished payments are polled after it
         fd_set read_fds;
         FD_ZERO(&read_fds);
-        FD_SET(stripe_fd, &read_fds);
         FD_SET(stdin_fd, &read_fds);
 
-        int max_fd = std::max(stripe_fd, stdin_fd) + 1;
+        int max_fd = stdin_fd + 1;
         struct timeval timeout;
-        timeout.tv_sec = 1; // Check every 1 second
-        timeout.tv_usec = 0;
+        timeout.tv_sec = 0;
+        timeout.tv_usec = 200000; // 200ms so confirmations go out promptly
 
         int ready = select(max_fd, &read_fds, nullptr, nullptr, &timeout);
         if (ready == -1) {
@@ -71,114 +400,198 @@ int main() {
             break;
         }
 
-        // Read available AVN messages from stripe_fifo
-        if (FD_ISSET(stripe_fd, &read_fds)) {
-            char buffer[512];
-            while (true) {
-                ssize_t n = read(stripe_fd, buffer, sizeof(buffer) - 1);
-                if (n <= 0) break; // No more messages or error
-                buffer[n] = '\0';
-                std::string avn_msg = buffer;
-
-                // Parse AVN message
-                AVN avn;
-                size_t pos = 0;
-                std::string token;
-                while (pos < avn_msg.length()) {
-                    size_t next_pos = avn_msg.find(',', pos);
-                    if (next_pos == std::string::npos) next_pos = avn_msg.length();
-                    token = avn_msg.substr(pos, next_pos - pos);
-                    pos = next_pos + 1;
-
-                    if (token.find("AVN_ID=") == 0) avn.avn_id = token.substr(7);
-                    else if (token.find("Flight=") == 0) avn.flight_id = token.substr(7);
-                    else if (token.find("Airline=") == 0) avn.airline = token.substr(8);
-                    else if (token.find("Type=") == 0) avn.aircraft_type = token.substr(5);
-                    else if (token.find("Speed=") == 0) avn.speed = token.substr(6);
-                    else if (token.find("Issued=") == 0) avn.issuance_time = token.substr(7);
-                    else if (token.find("Fine=") == 0) avn.fine_amount = std::stod(token.substr(5));
-                    else if (token.find("Status=") == 0) avn.payment_status = token.substr(7);
-                    else if (token.find("Due=") == 0) avn.due_date = token.substr(4);
+        // Read new AVN records from the bus, in place
+        AvnRecord rec;
+        while (reader.next(rec)) {
+            std::string_view avn_msg(rec.data, rec.length);
+            if (avn_msg.find("AVN_ID=") == std::string_view::npos) {
+                // Payment journaled by the generator (AVN=...,Flight=...,Status=paid), so a
+                // replay after a restart does not offer fines that were already paid
+                if (avn_msg.compare(0, 4, "AVN=") == 0 && avn_msg.find("Status=paid") != std::string_view::npos) {
+                    std::string avn_id(avn_msg.substr(4, avn_msg.find(',') - 4));
+                    AVN* avn = ledger.find(avn_id);
+                    if (avn && !avn->in_flight && reader.intact(rec)) {
+                        ledger.remove(avn_id);
+                        list_changed = true;
+                    }
+                }
+                continue;
+            }
+
+            AVN avn;
+            bool parsed = parse_avn_message(avn_msg, avn);
+            if (!reader.intact(rec)) continue; // overwritten while we parsed it
+            if (!parsed) {
+                std::cerr << "[StripePay] Invalid AVN record: " << avn_msg << std::endl;
+                continue;
+            }
+
+            // Add to pending ledger if unpaid
+            if (avn.payment_status == "unpaid") {
+                if (!ledger.add(avn)) {
+                    std::cout << "[StripePay] AVN " << avn.avn_id << " was already pending, replaced by the newer one" << std::endl;
                 }
+                received_since_draw++;
+                list_changed = true;
+            }
+        }
 
-                // Add to pending list if unpaid
-                if (avn.payment_status == "unpaid") {
-                    pending_avns.push_back(avn);
-                    std::cout << "[StripePay] Received AVN: " << avn.avn_id << ", Flight=" << avn.flight_id << std::endl;
+        // Retry confirmations the generator could not take yet
+        payments.flush();
+
+        // Hand finished payments back to the portal in one write
+        std::vector<PaymentResult> finished = pipeline.collect();
+        if (!finished.empty()) {
+            std::string confirmations;
+            for (const PaymentResult& result : finished) {
+                if (!result.success) {
+                    std::cout << "[StripePay] Payment failed for AVN=" << result.avn.avn_id << ", it stays pending" << std::endl;
+                    if (AVN* avn = ledger.find(result.avn.avn_id)) avn->in_flight = false;
+                    continue;
                 }
+                confirmations += "AVN=" + result.avn.avn_id + ",Status=paid\n";
+                std::cout << "[StripePay] Paid AVN=" << result.avn.avn_id << ", Flight=" << result.avn.flight_id
+                          << " (ref " << result.reference << ")" << std::endl;
+
+                // Remove from pending ledger
+                ledger.remove(result.avn.avn_id);
+            }
+            if (!confirmations.empty()) {
+                write_all(portal_fd, confirmations);
+                payments.send(confirmations);
+                std::cout << "[StripePay] Sent " << std::count(confirmations.begin(), confirmations.end(), '\n')
+                          << " confirmation(s) to portal" << std::endl;
             }
+            list_changed = true;
         }
 
-        // Display pending AVNs if there are any
-        if (!pending_avns.empty()) {
-            std::cout << "\n[StripePay] Pending AVN Challans:" << std::endl;
-            for (size_t i = 0; i < pending_avns.size(); ++i) {
-                const AVN& avn = pending_avns[i];
-                std::cout << "  " << i + 1 << ". AVN ID: " << avn.avn_id
-                          << ", Flight: " << avn.flight_id
-                          << ", Airline: " << avn.airline
-                          << ", Type: " << avn.aircraft_type
-                          << ", Fine: PKR " << avn.fine_amount
-                          << ", Due: " << avn.due_date << std::endl;
+        // Display one page of pending AVNs
+        if (list_changed) {
+            list_changed = false;
+            size_t total_rows = ledger.size(view_airline);
+            size_t page_count = (total_rows + PAGE_SIZE - 1) / PAGE_SIZE;
+            if (page_count == 0) page_count = 1;
+            if (page_number >= page_count) page_number = page_count - 1;
+            shown_ids = ledger.page(page_number, PAGE_SIZE, view_airline);
+
+            if (received_since_draw > 0) {
+                std::cout << "[StripePay] Received " << received_since_draw << " new AVN(s)" << std::endl;
+                received_since_draw = 0;
+            }
+            if (ledger.size() > 0) {
+                std::cout << "\n[StripePay] Pending AVN Challans: " << ledger.size()
+                          << " totalling PKR " << std::fixed << std::setprecision(2) << ledger.total();
+                std::cout.unsetf(std::ios::fixed);
+                std::cout << std::setprecision(6);
+                if (!view_airline.empty()) std::cout << "  [airline " << view_airline << ": " << total_rows << "]";
+                std::cout << "  page " << page_number + 1 << "/" << page_count << std::endl;
+                for (size_t i = 0; i < shown_ids.size(); ++i) {
+                    const AVN& avn = *ledger.find(shown_ids[i]);
+                    std::cout << "  " << i + 1 << ". AVN ID: " << avn.avn_id
+                              << ", Flight: " << avn.flight_id
+                              << ", Airline: " << avn.airline
+                              << ", Type: " << avn.aircraft_type
+                              << ", Fine: PKR " << avn.fine_amount
+                              << ", Due: " << avn.due_date
+                              << (avn.in_flight ? "  [processing]" : "") << std::endl;
+                }
+            } else {
+                std::cout << "[StripePay] No pending AVNs." << std::endl;
             }
-        } else {
-            std::cout << "[StripePay] No pending AVNs." << std::endl;
+            // Prompt user when something changed
+            std::cout << "[StripePay] Pay: <n>, <from>-<to>, <AVN ID>, all <airline> | next, prev, view <airline|all>, totals | 0 to skip/exit if no AVNs: " << std::flush;
         }
 
         // Check for user input from stdin
         if (FD_ISSET(stdin_fd, &read_fds)) {
-            char input_buffer[256];
-            ssize_t n = read(stdin_fd, input_buffer, sizeof(input_buffer) - 1);
-            if (n > 0) {
-                input_buffer[n] = '\0';
-                std::string input = input_buffer;
-                // Remove trailing newline
-                if (!input.empty() && input.back() == '\n') {
-                    input.pop_back();
-                }
+            input_reader.read_from(stdin_fd, input_lines);
+            for (std::string_view line : input_lines) {
+                std::string input(line);
+                list_changed = true;
 
-                int choice = 0;
-                try {
-                    choice = std::stoi(input);
-                } catch (...) {
-                    choice = 0;
+                // Paging and view commands
+                if (input == "next") { page_number++; continue; }
+                if (input == "prev") { if (page_number > 0) page_number--; continue; }
+                if (input.rfind("view ", 0) == 0) {
+                    view_airline = (input.substr(5) == "all") ? "" : input.substr(5);
+                    page_number = 0;
+                    continue;
+                }
+                if (input == "totals") {
+                    std::cout << "[StripePay] Pending per airline:" << std::endl;
+                    for (const auto& entry : ledger.airline_views()) {
+                        std::cout << "  " << entry.first << ": " << entry.second.count
+                                  << " fines, PKR " << std::fixed << std::setprecision(2) << entry.second.total << std::endl;
+                        std::cout.unsetf(std::ios::fixed);
+                        std::cout << std::setprecision(6);
+                    }
+                    continue;
                 }
 
-                if (!pending_avns.empty()) {
-                    if (choice > 0 && choice <= static_cast<int>(pending_avns.size())) {
-                        const AVN& selected_avn = pending_avns[choice - 1];
-                        std::cout << "[StripePay] Processing payment for Flight=" << selected_avn.flight_id << std::endl;
-                        sleep(3);
-
-                        // Send confirmation
-                        std::string confirmation = "AVN=" + selected_avn.avn_id + ",Status=paid\n";
-                        write(portal_fd, confirmation.c_str(), confirmation.size());
-                        std::cout << "[StripePay] Sent confirmation: " << confirmation;
+                // Work out which pending entries were selected
+                std::vector<std::string> selected;
+                bool valid = true;
+                if (input.rfind("all ", 0) == 0) {
+                    std::string airline = input.substr(4);
+                    selected = ledger.page(0, ledger.size(airline), airline);
+                    if (selected.empty()) {
+                        std::cout << "[StripePay] No pending AVNs for airline " << airline << std::endl;
+                        continue;
+                    }
+                } else if (input.rfind("AVN", 0) == 0) {
+                    if (!ledger.find(input)) {
+                        std::cout << "[StripePay] " << input << " is not pending" << std::endl;
+                        continue;
+                    }
+                    selected.push_back(input);
+                } else {
+                    int first = 0, last = 0;
+                    size_t dash = input.find('-');
+                    try {
+                        first = std::stoi(input.substr(0, dash));
+                        last = (dash == std::string::npos) ? first : std::stoi(input.substr(dash + 1));
+                    } catch (...) {
+                        first = last = 0;
+                    }
 
-                        // Remove from pending list
-                        pending_avns.erase(pending_avns.begin() + (choice - 1));
-                    } else if (choice == 0) {
+                    if (first == 0 && dash == std::string::npos) {
+                        if (ledger.size() == 0) {
+                            std::cout << "[StripePay] Exiting." << std::endl;
+                            running = false;
+                            break;
+                        }
                         std::cout << "[StripePay] Skipping payment." << std::endl;
-                    } else {
-                        std::cout << "[StripePay] Invalid choice, skipping." << std::endl;
+                        continue;
                     }
-                } else if (choice == 0) {
-                    std::cout << "[StripePay] Exiting." << std::endl;
-                    break;
+                    // numbers refer to rows on the page currently shown
+                    valid = first > 0 && last >= first && last <= static_cast<int>(shown_ids.size());
+                    for (int i = first; valid && i <= last; i++) selected.push_back(shown_ids[i - 1]);
                 }
+                if (!valid) {
+                    std::cout << "[StripePay] Invalid choice, skipping." << std::endl;
+                    continue;
+                }
+
+                // Queue them; the workers charge them while we keep reading AVNs and input
+                int submitted = 0;
+                for (const std::string& avn_id : selected) {
+                    AVN* avn = ledger.find(avn_id);
+                    if (!avn || avn->in_flight) continue; // already paid or being paid
+                    avn->in_flight = true;
+                    pipeline.submit(*avn);
+                    submitted++;
+                }
+                std::cout << "[StripePay] Queued " << submitted << " payment(s), " << pipeline.queued() << " waiting for a worker" << std::endl;
             }
         }
-
-        // Prompt user periodically
-        std::cout << "[StripePay] Enter the number of the AVN to pay (or 0 to skip/exit if no AVNs): ";
-
-        // Brief pause to avoid busy loop
-        usleep(100000); // 100ms
     }
 
     // Cleanup
-    close(stripe_fd);
     close(portal_fd);
+    payments.flush();
+    if (payments.queued() > 0) {
+        std::cerr << "[StripePay] " << payments.queued() << " payment(s) were never journaled by the AVN generator" << std::endl;
+    }
 
     return 0;
 }
@@ -0,0 +1,123 @@
+//AABIA ALI 23I-0704
+//INSHARAH IRFAN 23I-0615
+//CS-D
+
+// Incremental terminal output for atc_controller's console status.
+//
+// TerminalView keeps the last frame it drew as fixed-width lines. Each frame
+// the caller sets every line, then diff() returns the bytes that turn the
+// screen into the new frame: cursor moves (ANSI CUP) plus only the runs of
+// characters that changed. Runs closer than MERGE_GAP columns are joined,
+// since a cursor move costs about as much as a few characters.
+//
+// The view owns the top `height` rows of the terminal. The rows below it are
+// set up as the scroll region, so log lines printed there scroll without
+// touching the view. The cursor is saved before a frame is drawn and
+// restored after it, so the log output carries on where it left off.
+// Write the bytes with write_all() from fifo_reader.h.
+
+#ifndef TERM_VIEW_H
+#define TERM_VIEW_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdio>
+
+class TerminalView {
+public:
+    static const int MERGE_GAP = 4;
+
+    // Terminal size changed (or first frame): the next diff() clears and redraws everything
+    void resize(int terminal_rows, int terminal_cols, int view_height) {
+        rows = terminal_rows;
+        cols = terminal_cols;
+        height = view_height < rows ? view_height : rows;
+        current.assign(height, std::string(cols, ' '));
+        previous.assign(height, std::string(cols, ' '));
+        full = true;
+    }
+
+    int view_height() const { return height; }
+    int width() const { return cols; }
+
+    // Text for one row of this frame, cut or padded to the terminal width
+    void set_line(int row, std::string_view text) {
+        if (row < 0 || row >= height) return;
+        std::string& line = current[row];
+        size_t n = text.size() < size_t(cols) ? text.size() : size_t(cols);
+        line.replace(0, n, text.data(), n);
+        line.replace(n, cols - n, cols - n, ' ');
+    }
+
+    // Bytes that bring the screen from the last frame to this one, empty if nothing changed
+    const std::string& diff() {
+        out.clear();
+        if (full) {
+            // clear, keep the rows under the view as a scrolling log, park the cursor there
+            append("\x1b[2J");
+            if (height < rows) {
+                char region[32];
+                snprintf(region, sizeof(region), "\x1b[%d;%dr\x1b[%d;1H", height + 1, rows, rows);
+                append(region);
+            }
+        }
+        size_t header = out.size();
+        append("\x1b" "7"); // save cursor
+        size_t saved = out.size();
+        for (int r = 0; r < height; r++) {
+            const std::string& now = current[r];
+            const std::string& before = previous[r];
+            int c = 0;
+            while (c < cols) {
+                if (!full && now[c] == before[c]) {
+                    c++;
+                    continue;
+                }
+                int start = c, end = c + 1, same = 0;
+                for (int k = c + 1; k < cols && (full || same < MERGE_GAP); k++) {
+                    if (!full && now[k] == before[k]) {
+                        same++;
+                    } else {
+                        same = 0;
+                        end = k + 1;
+                    }
+                }
+                move_to(r, start);
+                out.append(now, start, end - start);
+                c = end;
+            }
+        }
+        if (out.size() == saved) {
+            out.resize(header); // nothing in the view changed
+        } else {
+            append("\x1b" "8"); // restore cursor
+        }
+        for (int r = 0; r < height; r++) previous[r].assign(current[r]);
+        full = false;
+        return out;
+    }
+
+    // Give the terminal back: whole screen scrolls again, cursor under the view
+    std::string release() const {
+        char reset[32];
+        snprintf(reset, sizeof(reset), "\x1b[r\x1b[%d;1H\n", rows);
+        return reset;
+    }
+
+private:
+    void append(const char* s) { out.append(s); }
+
+    void move_to(int row, int col) {
+        char cup[24];
+        int n = snprintf(cup, sizeof(cup), "\x1b[%d;%dH", row + 1, col + 1);
+        out.append(cup, n);
+    }
+
+    int rows = 0, cols = 0, height = 0;
+    std::vector<std::string> current, previous;
+    std::string out;
+    bool full = true;
+};
+
+#endif
@@ -0,0 +1,154 @@
+//AABIA ALI 23I-0704
+//INSHARAH IRFAN 23I-0615
+//CS-D
+
+// Timing for the simulation tick loop in atc_controller.
+//
+// LatencyHistogram keeps microsecond samples in power of two buckets, so
+// recording is one increment and percentiles come out within a factor of 2
+// (the report shows each bucket's upper bound, plus the exact max).
+//
+// SlowTickTracer collects spans while a tick runs and, if the tick went over
+// its budget, writes them to a Chrome trace-event file (chrome://tracing or
+// ui.perfetto.dev). The file is a JSON array written one event at a time;
+// the viewers accept it without the closing bracket, so a crashed run still loads.
+
+#ifndef TICK_TRACE_H
+#define TICK_TRACE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+
+inline int64_t trace_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class LatencyHistogram {
+public:
+    static const int BUCKETS = 40; // bucket i holds [2^(i-1), 2^i) us, bucket 0 holds 0
+
+    void add(int64_t us) {
+        if (us < 0) us = 0;
+        int bucket = 0;
+        while (bucket < BUCKETS - 1 && (int64_t(1) << bucket) <= us) bucket++;
+        counts[bucket]++;
+        samples++;
+        total += us;
+        if (us > largest) largest = us;
+    }
+
+    // Upper bound of the bucket holding the p-th percentile (0-100)
+    int64_t percentile(double p) const {
+        if (samples == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * samples);
+        if (rank >= samples) rank = samples - 1;
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            seen += counts[b];
+            if (seen > rank) return b == 0 ? 0 : std::min(largest, (int64_t(1) << b) - 1);
+        }
+        return largest;
+    }
+
+    uint64_t count() const { return samples; }
+    int64_t max() const { return largest; }
+    double mean() const { return samples ? double(total) / samples : 0.0; }
+
+private:
+    uint64_t counts[BUCKETS] = {};
+    uint64_t samples = 0;
+    int64_t total = 0;
+    int64_t largest = 0;
+};
+
+class SlowTickTracer {
+public:
+    static const size_t MAX_SPANS = 10000; // per tick, a runaway tick should not eat memory
+
+    ~SlowTickTracer() { close(); }
+
+    bool open(const char* path) {
+        out = fopen(path, "w");
+        if (!out) return false;
+        fputs("[\n", out);
+        spans.reserve(256);
+        return true;
+    }
+
+    void begin(int tick, int64_t start_us) {
+        current_tick = tick;
+        tick_start = start_us;
+        spans.clear();
+        dropped = 0;
+    }
+
+    // name should be a string literal; detail is not copied, so it must outlive
+    // the tick (atc_controller passes interned flight ids)
+    void span(const char* name, int64_t start_us, int64_t dur_us, std::string_view detail = {}) {
+        if (spans.size() >= MAX_SPANS) {
+            dropped++;
+            return;
+        }
+        spans.push_back({name, start_us, dur_us, detail});
+    }
+
+    // Close the tick; its spans are written only when it went over budget
+    void end(int64_t work_us, int64_t drift_us, bool over_budget) {
+        if (!out || !over_budget) return;
+        char line[256];
+        snprintf(line, sizeof(line),
+                 "{\"name\":\"tick %d\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%lld,\"dur\":%lld,"
+                 "\"args\":{\"drift_us\":%lld,\"spans_dropped\":%zu}},\n",
+                 current_tick, (long long)tick_start, (long long)work_us, (long long)drift_us, dropped);
+        fputs(line, out);
+        for (const Span& s : spans) {
+            snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%lld,\"dur\":%lld",
+                     s.name, (long long)s.start_us, (long long)s.dur_us);
+            fputs(line, out);
+            if (!s.detail.empty()) {
+                fputs(",\"args\":{\"detail\":\"", out);
+                for (char c : s.detail) {
+                    if (c == '"' || c == '\\') fputc('\\', out);
+                    if (static_cast<unsigned char>(c) >= 0x20) fputc(c, out);
+                }
+                fputs("\"}", out);
+            }
+            fputs("},\n", out);
+        }
+        fflush(out);
+        traced++;
+    }
+
+    void close() {
+        if (!out) return;
+        // metadata event so the array can end without a trailing comma
+        fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"atc_controller tick loop\"}}\n]\n", out);
+        fclose(out);
+        out = nullptr;
+    }
+
+    long traced_ticks() const { return traced; }
+
+private:
+    struct Span {
+        const char* name;
+        int64_t start_us;
+        int64_t dur_us;
+        std::string_view detail;
+    };
+
+    FILE* out = nullptr;
+    std::vector<Span> spans;
+    int current_tick = 0;
+    int64_t tick_start = 0;
+    size_t dropped = 0;
+    long traced = 0;
+};
+
+#endif